@@ -0,0 +1,176 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Abilities/RPGAbilityLoadout.h"
+#include "Abilities/RPGGameplayAbility.h"
+#include "AbilitySystemComponent.h"
+#include "GameplayEffect.h"
+
+TMap<FObjectKey, TSharedRef<const FRPGAbilityLoadout>>& FRPGAbilityLoadout::GetLoadouts()
+{
+	static TMap<FObjectKey, TSharedRef<const FRPGAbilityLoadout>> Loadouts;
+	return Loadouts;
+}
+
+TSharedRef<const FRPGAbilityLoadout> FRPGAbilityLoadout::Get(const UClass* OwnerClass, const TArray<TSubclassOf<URPGGameplayAbility>>& Abilities, const TArray<TSubclassOf<UGameplayEffect>>& PassiveEffects)
+{
+	check(IsInGameThread());
+
+	const FObjectKey OwnerKey(OwnerClass);
+	if (const TSharedRef<const FRPGAbilityLoadout>* Found = GetLoadouts().Find(OwnerKey))
+	{
+		if ((*Found)->MatchesSource(Abilities, PassiveEffects))
+		{
+			return *Found;
+		}
+	}
+
+	// Build a new one rather than changing the old one, callers may still hold it
+	TSharedRef<FRPGAbilityLoadout> Loadout = MakeShared<FRPGAbilityLoadout>();
+	Loadout->Build(Abilities, PassiveEffects);
+	GetLoadouts().Add(OwnerKey, Loadout);
+	return Loadout;
+}
+
+bool FRPGAbilityLoadout::MatchesSource(const TArray<TSubclassOf<URPGGameplayAbility>>& Abilities, const TArray<TSubclassOf<UGameplayEffect>>& PassiveEffects) const
+{
+	if (SourceAbilities.Num() != Abilities.Num() || SourcePassiveEffects.Num() != PassiveEffects.Num())
+	{
+		return false;
+	}
+
+	for (int32 Index = 0; Index < Abilities.Num(); Index++)
+	{
+		if (SourceAbilities[Index] != FObjectKey(*Abilities[Index]))
+		{
+			return false;
+		}
+	}
+
+	for (int32 Index = 0; Index < PassiveEffects.Num(); Index++)
+	{
+		if (SourcePassiveEffects[Index] != FObjectKey(*PassiveEffects[Index]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FRPGAbilityLoadout::Build(const TArray<TSubclassOf<URPGGameplayAbility>>& Abilities, const TArray<TSubclassOf<UGameplayEffect>>& PassiveEffects)
+{
+	SourceAbilities.Reset(Abilities.Num());
+	for (const TSubclassOf<URPGGameplayAbility>& Ability : Abilities)
+	{
+		SourceAbilities.Add(FObjectKey(*Ability));
+	}
+
+	SourcePassiveEffects.Reset(PassiveEffects.Num());
+	for (const TSubclassOf<UGameplayEffect>& Effect : PassiveEffects)
+	{
+		SourcePassiveEffects.Add(FObjectKey(*Effect));
+	}
+
+	AbilityClasses.Reset();
+	for (const TSubclassOf<URPGGameplayAbility>& Ability : Abilities)
+	{
+		if (Ability)
+		{
+			AbilityClasses.AddUnique(Ability);
+		}
+	}
+
+	PersistentEffects.Reset();
+	InstantEffects.Reset();
+	for (const TSubclassOf<UGameplayEffect>& Effect : PassiveEffects)
+	{
+		if (const UGameplayEffect* EffectDefaults = Effect ? Effect->GetDefaultObject<UGameplayEffect>() : nullptr)
+		{
+			if (EffectDefaults->DurationPolicy == EGameplayEffectDurationType::Instant)
+			{
+				InstantEffects.Add(Effect);
+			}
+			else
+			{
+				PersistentEffects.Add(Effect);
+			}
+		}
+	}
+}
+
+void FRPGAbilityLoadout::GiveAbilities(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject, int32 Level, FRPGGrantedAbilityLoadout& OutGranted) const
+{
+	OutGranted.AbilityHandles.Reserve(OutGranted.AbilityHandles.Num() + AbilityClasses.Num());
+	for (const TSubclassOf<URPGGameplayAbility>& Ability : AbilityClasses)
+	{
+		OutGranted.AbilityHandles.Add(AbilitySystem->GiveAbility(FGameplayAbilitySpec(Ability, Level, INDEX_NONE, SourceObject)));
+	}
+}
+
+void FRPGAbilityLoadout::ApplyPassiveEffects(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject, int32 Level, FRPGGrantedAbilityLoadout& OutGranted) const
+{
+	if (PersistentEffects.Num() == 0 && InstantEffects.Num() == 0)
+	{
+		return;
+	}
+
+	FGameplayEffectContextHandle EffectContext = AbilitySystem->MakeEffectContext();
+	EffectContext.AddSourceObject(SourceObject);
+
+	OutGranted.EffectHandles.Reserve(OutGranted.EffectHandles.Num() + PersistentEffects.Num());
+	for (const TSubclassOf<UGameplayEffect>& Effect : PersistentEffects)
+	{
+		const FActiveGameplayEffectHandle Handle = AbilitySystem->ApplyGameplayEffectSpecToSelf(FGameplayEffectSpec(Effect->GetDefaultObject<UGameplayEffect>(), EffectContext, Level));
+		if (Handle.IsValid())
+		{
+			OutGranted.EffectHandles.Add(Handle);
+		}
+	}
+
+	for (const TSubclassOf<UGameplayEffect>& Effect : InstantEffects)
+	{
+		AbilitySystem->ApplyGameplayEffectSpecToSelf(FGameplayEffectSpec(Effect->GetDefaultObject<UGameplayEffect>(), EffectContext, Level));
+	}
+}
+
+void FRPGAbilityLoadout::SetAbilityLevel(UAbilitySystemComponent* AbilitySystem, int32 Level, const FRPGGrantedAbilityLoadout& Granted) const
+{
+	for (const FGameplayAbilitySpecHandle& Handle : Granted.AbilityHandles)
+	{
+		FGameplayAbilitySpec* Spec = AbilitySystem->FindAbilitySpecFromHandle(Handle);
+		if (Spec && Spec->Level != Level)
+		{
+			Spec->Level = Level;
+			AbilitySystem->MarkAbilitySpecDirty(*Spec);
+		}
+	}
+}
+
+void FRPGAbilityLoadout::SetPassiveEffectLevel(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject, int32 Level, FRPGGrantedAbilityLoadout& Granted) const
+{
+	// Drop handles of effects that were removed since they were applied
+	Granted.EffectHandles.RemoveAll([AbilitySystem](const FActiveGameplayEffectHandle& Handle) { return !AbilitySystem->GetActiveGameplayEffect(Handle); });
+	for (const FActiveGameplayEffectHandle& Handle : Granted.EffectHandles)
+	{
+		AbilitySystem->SetActiveGameplayEffectLevel(Handle, Level);
+	}
+
+	if (InstantEffects.Num() > 0)
+	{
+		FGameplayEffectContextHandle EffectContext = AbilitySystem->MakeEffectContext();
+		EffectContext.AddSourceObject(SourceObject);
+
+		for (const TSubclassOf<UGameplayEffect>& Effect : InstantEffects)
+		{
+			AbilitySystem->ApplyGameplayEffectSpecToSelf(FGameplayEffectSpec(Effect->GetDefaultObject<UGameplayEffect>(), EffectContext, Level));
+		}
+	}
+}
+
+void FRPGAbilityLoadout::ClearAbilities(UAbilitySystemComponent* AbilitySystem, FRPGGrantedAbilityLoadout& Granted)
+{
+	for (const FGameplayAbilitySpecHandle& Handle : Granted.AbilityHandles)
+	{
+		AbilitySystem->ClearAbility(Handle);
+	}
+	Granted.AbilityHandles.Reset();
+}
@@ -3,28 +3,236 @@
 #include "Abilities/RPGAbilitySystemComponent.h"
 #include "RPGCharacterBase.h"
 #include "Abilities/RPGGameplayAbility.h"
+#include "Abilities/RPGGameplayEventRegistry.h"
 #include "AbilitySystemGlobals.h"
 
-URPGAbilitySystemComponent::URPGAbilitySystemComponent() {}
+URPGAbilitySystemComponent::URPGAbilitySystemComponent()
+	: GameplayEventDispatchDepth(0)
+	, bAbilityTagIndexDirty(true)
+	, CooldownGeneration(1)
+{}
 
 void URPGAbilitySystemComponent::GetActiveAbilitiesWithTags(const FGameplayTagContainer& GameplayTagContainer, TArray<URPGGameplayAbility*>& ActiveAbilities)
 {
-	TArray<FGameplayAbilitySpec*> AbilitiesToActivate;
-	GetActivatableGameplayAbilitySpecsByAllMatchingTags(GameplayTagContainer, AbilitiesToActivate, false);
+	GetActiveAbilitiesWithTags<FDefaultAllocator>(GameplayTagContainer, ActiveAbilities);
+}
+
+bool URPGAbilitySystemComponent::IsAnyAbilityActiveWithTags(const FGameplayTagContainer& GameplayTagContainer)
+{
+	if (GameplayTagContainer.Num() == 1)
+	{
+		const int32* ActiveCount = ActiveAbilityTagCounts.Find(GameplayTagContainer.First());
+		return ActiveCount && *ActiveCount > 0;
+	}
 
-	// Iterate the list of all ability specs
-	for (FGameplayAbilitySpec* Spec : AbilitiesToActivate)
+	// An ability has to have all of the tags, which the per tag counts can't tell
+	bool bFoundActive = false;
+	ForEachAbilitySpecWithTags(GameplayTagContainer, [&bFoundActive](FGameplayAbilitySpec& Spec)
 	{
-		// Iterate all instances on this ability spec
-		TArray<UGameplayAbility*> AbilityInstances = Spec->GetAbilityInstances();
+		bFoundActive = Spec.IsActive();
+		return !bFoundActive;
+	});
+	return bFoundActive;
+}
+
+FDelegateHandle URPGAbilitySystemComponent::AddGameplayEventListener(const FGameplayTagContainer& FilterTags, const UClass* OwnerClass, FRPGGameplayEventDelegate Delegate)
+{
+	TArray<FGameplayEventListener>& Listeners = GameplayEventDispatchDepth > 0 ? PendingGameplayEventListeners : GameplayEventListeners;
 
-		for (UGameplayAbility* ActiveAbility : AbilityInstances)
+	FGameplayEventListener& Listener = Listeners.AddDefaulted_GetRef();
+	Listener.FilterTags = FilterTags;
+	Listener.FilterMask = FRPGGameplayEventTagRegistry::Get().CompileFilter(OwnerClass, FilterTags, Listener.bExactMask);
+	Listener.Delegate = MoveTemp(Delegate);
+
+	return Listener.Delegate.GetHandle();
+}
+
+void URPGAbilitySystemComponent::RemoveGameplayEventListener(FDelegateHandle Handle)
+{
+	if (!Handle.IsValid())
+	{
+		return;
+	}
+
+	PendingGameplayEventListeners.RemoveAll([Handle](const FGameplayEventListener& Listener) { return Listener.Delegate.GetHandle() == Handle; });
+
+	for (int32 Index = 0; Index < GameplayEventListeners.Num(); Index++)
+	{
+		if (GameplayEventListeners[Index].Delegate.GetHandle() == Handle)
+		{
+			// Leave the slot in place while dispatching, it gets compacted afterwards
+			if (GameplayEventDispatchDepth > 0)
+			{
+				GameplayEventListeners[Index].Delegate.Unbind();
+			}
+			else
+			{
+				GameplayEventListeners.RemoveAt(Index);
+			}
+			return;
+		}
+	}
+}
+
+int32 URPGAbilitySystemComponent::HandleGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload)
+{
+	const int32 TriggeredCount = Super::HandleGameplayEvent(EventTag, Payload);
+
+	if (Payload && GameplayEventListeners.Num() > 0)
+	{
+		DispatchGameplayEventToListeners(EventTag, *Payload);
+	}
+
+	return TriggeredCount;
+}
+
+void URPGAbilitySystemComponent::DispatchGameplayEventToListeners(FGameplayTag EventTag, const FGameplayEventData& Payload)
+{
+	const uint64 EventMask = FRPGGameplayEventTagRegistry::Get().GetEventMask(EventTag);
+
+	GameplayEventDispatchDepth++;
+	for (int32 Index = 0; Index < GameplayEventListeners.Num(); Index++)
+	{
+		const FGameplayEventListener& Listener = GameplayEventListeners[Index];
+		const bool bMatches = Listener.FilterTags.IsEmpty() || (Listener.bExactMask ? (Listener.FilterMask & EventMask) != 0 : EventTag.MatchesAny(Listener.FilterTags));
+		if (bMatches)
+		{
+			Listener.Delegate.ExecuteIfBound(EventTag, Payload);
+		}
+	}
+	GameplayEventDispatchDepth--;
+
+	if (GameplayEventDispatchDepth == 0)
+	{
+		GameplayEventListeners.RemoveAll([](const FGameplayEventListener& Listener) { return !Listener.Delegate.IsBound(); });
+		if (PendingGameplayEventListeners.Num() > 0)
 		{
-			ActiveAbilities.Add(Cast<URPGGameplayAbility>(ActiveAbility));
+			GameplayEventListeners.Append(MoveTemp(PendingGameplayEventListeners));
+			PendingGameplayEventListeners.Reset();
 		}
 	}
 }
 
+void URPGAbilitySystemComponent::NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability)
+{
+	Super::NotifyAbilityActivated(Handle, Ability);
+
+	if (Ability)
+	{
+		for (const FGameplayTag& AbilityTag : Ability->AbilityTags.GetGameplayTagParents())
+		{
+			ActiveAbilityTagCounts.FindOrAdd(AbilityTag)++;
+		}
+	}
+}
+
+void URPGAbilitySystemComponent::NotifyAbilityEnded(FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, bool bWasCancelled)
+{
+	if (Ability)
+	{
+		for (const FGameplayTag& AbilityTag : Ability->AbilityTags.GetGameplayTagParents())
+		{
+			int32* ActiveCount = ActiveAbilityTagCounts.Find(AbilityTag);
+			if (ActiveCount && --(*ActiveCount) <= 0)
+			{
+				ActiveAbilityTagCounts.Remove(AbilityTag);
+			}
+		}
+	}
+
+	Super::NotifyAbilityEnded(Handle, Ability, bWasCancelled);
+}
+
+void URPGAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnGiveAbility(AbilitySpec);
+	bAbilityTagIndexDirty = true;
+}
+
+void URPGAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnRemoveAbility(AbilitySpec);
+	bAbilityTagIndexDirty = true;
+}
+
+void URPGAbilitySystemComponent::UpdateAbilityTagIndex()
+{
+	if (!bAbilityTagIndexDirty)
+	{
+		return;
+	}
+	bAbilityTagIndexDirty = false;
+
+	AbilityTagIndex.Reset();
+	AllAbilityHandles.Reset();
+
+	for (const FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	{
+		if (!Spec.Ability)
+		{
+			continue;
+		}
+
+		AllAbilityHandles.Add(Spec.Handle);
+
+		// Index parents too, a query for Ability.Melee has to find an ability tagged Ability.Melee.Combo
+		for (const FGameplayTag& AbilityTag : Spec.Ability->AbilityTags.GetGameplayTagParents())
+		{
+			AbilityTagIndex.FindOrAdd(AbilityTag).Add(Spec.Handle);
+		}
+	}
+}
+
+void URPGAbilitySystemComponent::GetAbilityHandlesWithTags(const FGameplayTagContainer& GameplayTagContainer, const FGameplayAbilitySpecHandle*& OutHandles, int32& OutNumHandles)
+{
+	UpdateAbilityTagIndex();
+
+	// Start from the tag with the fewest abilities, every match has to be in it
+	OutHandles = AllAbilityHandles.GetData();
+	OutNumHandles = AllAbilityHandles.Num();
+
+	for (const FGameplayTag& Tag : GameplayTagContainer)
+	{
+		const TArray<FGameplayAbilitySpecHandle, TInlineAllocator<4>>* TaggedHandles = AbilityTagIndex.Find(Tag);
+		if (!TaggedHandles)
+		{
+			OutHandles = nullptr;
+			OutNumHandles = 0;
+			return;
+		}
+		if (TaggedHandles->Num() < OutNumHandles)
+		{
+			OutHandles = TaggedHandles->GetData();
+			OutNumHandles = TaggedHandles->Num();
+		}
+	}
+}
+
+bool URPGAbilitySystemComponent::TryActivateAbilitiesByTagIndexed(const FGameplayTagContainer& GameplayTagContainer, bool bAllowRemoteActivation)
+{
+	const FGameplayAbilitySpecHandle* Candidates = nullptr;
+	int32 NumCandidates = 0;
+	GetAbilityHandlesWithTags(GameplayTagContainer, Candidates, NumCandidates);
+
+	// Collect first, activating can give or remove abilities and rebuild the index
+	TArray<FGameplayAbilitySpecHandle, TInlineAllocator<4>> HandlesToActivate;
+	for (int32 Index = 0; Index < NumCandidates; Index++)
+	{
+		const FGameplayAbilitySpec* Spec = FindAbilitySpecFromHandle(Candidates[Index]);
+		if (Spec && Spec->Ability && Spec->Ability->AbilityTags.HasAll(GameplayTagContainer) && Spec->Ability->DoesAbilitySatisfyTagRequirements(*this))
+		{
+			HandlesToActivate.Add(Spec->Handle);
+		}
+	}
+
+	bool bSuccess = false;
+	for (const FGameplayAbilitySpecHandle& Handle : HandlesToActivate)
+	{
+		bSuccess |= TryActivateAbility(Handle, bAllowRemoteActivation);
+	}
+	return bSuccess;
+}
+
 int32 URPGAbilitySystemComponent::GetDefaultAbilityLevel() const
 {
 	ARPGCharacterBase* OwningCharacter = Cast<ARPGCharacterBase>(OwnerActor);
@@ -40,3 +248,117 @@ URPGAbilitySystemComponent* URPGAbilitySystemComponent::GetAbilitySystemComponen
 {
 	return Cast<URPGAbilitySystemComponent>(UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor, LookForComponent));
 }
+
+void URPGAbilitySystemComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Cooldown tags are all children of Cooldown, so the parent count changes whenever any cooldown starts or ends
+	CooldownRootTag = FGameplayTag::RequestGameplayTag(FName(TEXT("Cooldown")), false);
+	if (CooldownRootTag.IsValid() && !CooldownTagChangedHandle.IsValid())
+	{
+		CooldownTagChangedHandle = RegisterGameplayTagEvent(CooldownRootTag, EGameplayTagEventType::AnyCountChange).AddUObject(this, &URPGAbilitySystemComponent::OnCooldownTagChanged);
+	}
+
+	// A cooldown can also be reapplied or removed without changing the tag count
+	if (!CooldownEffectAddedHandle.IsValid())
+	{
+		CooldownEffectAddedHandle = OnActiveGameplayEffectAddedDelegateToSelf.AddUObject(this, &URPGAbilitySystemComponent::OnCooldownEffectAdded);
+	}
+	if (!CooldownEffectRemovedHandle.IsValid())
+	{
+		CooldownEffectRemovedHandle = OnAnyGameplayEffectRemovedDelegate().AddUObject(this, &URPGAbilitySystemComponent::OnCooldownEffectRemoved);
+	}
+}
+
+void URPGAbilitySystemComponent::OnUnregister()
+{
+	if (CooldownTagChangedHandle.IsValid())
+	{
+		RegisterGameplayTagEvent(CooldownRootTag, EGameplayTagEventType::AnyCountChange).Remove(CooldownTagChangedHandle);
+		CooldownTagChangedHandle.Reset();
+	}
+
+	OnActiveGameplayEffectAddedDelegateToSelf.Remove(CooldownEffectAddedHandle);
+	CooldownEffectAddedHandle.Reset();
+
+	OnAnyGameplayEffectRemovedDelegate().Remove(CooldownEffectRemovedHandle);
+	CooldownEffectRemovedHandle.Reset();
+
+	Super::OnUnregister();
+}
+
+void URPGAbilitySystemComponent::OnCooldownTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	InvalidateCooldownCache();
+}
+
+void URPGAbilitySystemComponent::OnCooldownEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& SpecApplied, FActiveGameplayEffectHandle ActiveHandle)
+{
+	FGameplayTagContainer GrantedTags;
+	SpecApplied.GetAllGrantedTags(GrantedTags);
+	if (GrantedTags.HasTag(CooldownRootTag))
+	{
+		InvalidateCooldownCache();
+	}
+}
+
+void URPGAbilitySystemComponent::OnCooldownEffectRemoved(const FActiveGameplayEffect& RemovedEffect)
+{
+	FGameplayTagContainer GrantedTags;
+	RemovedEffect.Spec.GetAllGrantedTags(GrantedTags);
+	if (GrantedTags.HasTag(CooldownRootTag))
+	{
+		InvalidateCooldownCache();
+	}
+}
+
+bool URPGAbilitySystemComponent::GetCooldownRemainingForTags(const FGameplayTagContainer& CooldownTags, float& TimeRemaining, float& CooldownDuration)
+{
+	TimeRemaining = 0.f;
+	CooldownDuration = 0.f;
+
+	UWorld* World = GetWorld();
+	if (!World || CooldownTags.Num() == 0)
+	{
+		return false;
+	}
+
+	const float Now = World->GetTimeSeconds();
+	bool bFound = false;
+
+	for (const FGameplayTag& CooldownTag : CooldownTags)
+	{
+		// The cache is only invalidated by changes under CooldownRootTag, any other tag is queried every time
+		FCachedCooldown Uncached;
+		const bool bCacheable = CooldownRootTag.IsValid() && CooldownTag.MatchesTag(CooldownRootTag);
+		FCachedCooldown& Cached = bCacheable ? CooldownCache.FindOrAdd(CooldownTag) : Uncached;
+		if (Cached.Generation != CooldownGeneration)
+		{
+			// Something changed since this tag was last queried, find the longest matching effect again
+			Cached.EndTime = 0.f;
+			Cached.Duration = 0.f;
+			Cached.Generation = CooldownGeneration;
+
+			FGameplayEffectQuery const Query = FGameplayEffectQuery::MakeQuery_MatchAnyOwningTags(FGameplayTagContainer(CooldownTag));
+			for (const TPair<float, float>& DurationAndTimeRemaining : GetActiveEffectsTimeRemainingAndDuration(Query))
+			{
+				if (Now + DurationAndTimeRemaining.Key > Cached.EndTime)
+				{
+					Cached.EndTime = Now + DurationAndTimeRemaining.Key;
+					Cached.Duration = DurationAndTimeRemaining.Value;
+				}
+			}
+		}
+
+		const float Remaining = Cached.EndTime - Now;
+		if (Remaining > 0.f && (!bFound || Remaining > TimeRemaining))
+		{
+			TimeRemaining = Remaining;
+			CooldownDuration = Cached.Duration;
+			bFound = true;
+		}
+	}
+
+	return bFound;
+}
@@ -2,6 +2,7 @@
 
 #include "Abilities/RPGAbilityTask_PlayMontageAndWaitForEvent.h"
 #include "Abilities/RPGAbilitySystemComponent.h"
+#include "Abilities/RPGGameplayAbility.h"
 #include "GameFramework/Character.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
@@ -12,6 +13,9 @@ URPGAbilityTask_PlayMontageAndWaitForEvent::URPGAbilityTask_PlayMontageAndWaitFo
 {
 	Rate = 1.f;
 	bStopWhenAbilityEnds = true;
+	bUsingEventListener = false;
+	bPooled = false;
+	ActivationSerial = 0;
 }
 
 URPGAbilitySystemComponent* URPGAbilityTask_PlayMontageAndWaitForEvent::GetTargetASC()
@@ -19,8 +23,14 @@ URPGAbilitySystemComponent* URPGAbilityTask_PlayMontageAndWaitForEvent::GetTarge
 	return Cast<URPGAbilitySystemComponent>(AbilitySystemComponent);
 }
 
-void URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted)
+void URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted, uint32 Serial)
 {
+	// A pooled task can be playing again while the montage of an earlier use is still blending out
+	if (!IsActive() || Serial != ActivationSerial)
+	{
+		return;
+	}
+
 	if (Ability && Ability->GetCurrentMontage() == MontageToPlay)
 	{
 		if (Montage == MontageToPlay)
@@ -56,6 +66,12 @@ void URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageBlendingOut(UAnimMonta
 
 void URPGAbilityTask_PlayMontageAndWaitForEvent::OnAbilityCancelled()
 {
+	// Pooled tasks stay bound while waiting in the pool
+	if (!IsActive())
+	{
+		return;
+	}
+
 	// TODO: Merge this fix back to engine, it was calling the wrong callback
 
 	if (StopPlayingMontage())
@@ -68,8 +84,13 @@ void URPGAbilityTask_PlayMontageAndWaitForEvent::OnAbilityCancelled()
 	}
 }
 
-void URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageEnded(UAnimMontage* Montage, bool bInterrupted)
+void URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageEnded(UAnimMontage* Montage, bool bInterrupted, uint32 Serial)
 {
+	if (!IsActive() || Serial != ActivationSerial)
+	{
+		return;
+	}
+
 	if (!bInterrupted)
 	{
 		if (ShouldBroadcastAbilityTaskDelegates())
@@ -83,12 +104,25 @@ void URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageEnded(UAnimMontage* Mo
 
 void URPGAbilityTask_PlayMontageAndWaitForEvent::OnGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload)
 {
-	if (ShouldBroadcastAbilityTaskDelegates())
+	OnGameplayEventListener(EventTag, *Payload);
+}
+
+void URPGAbilityTask_PlayMontageAndWaitForEvent::OnGameplayEventListener(FGameplayTag EventTag, const FGameplayEventData& Payload)
+{
+	if (IsActive() && ShouldBroadcastAbilityTaskDelegates())
 	{
-		FGameplayEventData TempData = *Payload;
-		TempData.EventTag = EventTag;
+		// Senders normally fill in the tag already, only copy when it has to be set
+		if (Payload.EventTag == EventTag)
+		{
+			EventReceived.Broadcast(EventTag, Payload);
+		}
+		else
+		{
+			FGameplayEventData TempData = Payload;
+			TempData.EventTag = EventTag;
 
-		EventReceived.Broadcast(EventTag, TempData);
+			EventReceived.Broadcast(EventTag, TempData);
+		}
 	}
 }
 
@@ -97,7 +131,19 @@ URPGAbilityTask_PlayMontageAndWaitForEvent* URPGAbilityTask_PlayMontageAndWaitFo
 {
 	UAbilitySystemGlobals::NonShipping_ApplyGlobalAbilityScaler_Rate(Rate);
 
-	URPGAbilityTask_PlayMontageAndWaitForEvent* MyObj = NewAbilityTask<URPGAbilityTask_PlayMontageAndWaitForEvent>(OwningAbility, TaskInstanceName);
+	URPGGameplayAbility* RPGAbility = Cast<URPGGameplayAbility>(OwningAbility);
+	const bool bPoolTask = RPGAbility && RPGAbility->ShouldPoolMontageTasks();
+
+	URPGAbilityTask_PlayMontageAndWaitForEvent* MyObj = bPoolTask ? RPGAbility->TakePooledMontageTask() : nullptr;
+	if (MyObj)
+	{
+		MyObj->ResetForReuse(*OwningAbility, TaskInstanceName);
+	}
+	else
+	{
+		MyObj = NewAbilityTask<URPGAbilityTask_PlayMontageAndWaitForEvent>(OwningAbility, TaskInstanceName);
+		MyObj->bPooled = bPoolTask;
+	}
 	MyObj->MontageToPlay = MontageToPlay;
 	MyObj->EventTags = EventTags;
 	MyObj->Rate = Rate;
@@ -108,6 +154,78 @@ URPGAbilityTask_PlayMontageAndWaitForEvent* URPGAbilityTask_PlayMontageAndWaitFo
 	return MyObj;
 }
 
+void URPGAbilityTask_PlayMontageAndWaitForEvent::ResetForReuse(UGameplayAbility& OwningAbility, FName TaskInstanceName)
+{
+	// Blueprint bindings belong to whichever node used the task last, the calling node binds its own after this returns
+	OnCompleted.Clear();
+	OnBlendOut.Clear();
+	OnInterrupted.Clear();
+	OnCancelled.Clear();
+	EventReceived.Clear();
+
+	ClearWaitingOnAvatar();
+	InstanceName = TaskInstanceName;
+	InitTask(OwningAbility, OwningAbility.GetGameplayTaskDefaultPriority());
+}
+
+void URPGAbilityTask_PlayMontageAndWaitForEvent::ReleaseFromPool()
+{
+	if (Ability)
+	{
+		Ability->OnGameplayAbilityCancelled.Remove(CancelledHandle);
+	}
+	CancelledHandle.Reset();
+
+	UnbindEventCallback(GetTargetASC());
+	UnbindMontageDelegates();
+
+	bPooled = false;
+	MarkPendingKill();
+}
+
+void URPGAbilityTask_PlayMontageAndWaitForEvent::BindEventCallback(URPGAbilitySystemComponent* RPGAbilitySystemComponent)
+{
+	const URPGGameplayAbility* RPGAbility = Cast<URPGGameplayAbility>(Ability);
+	const bool bWantsEventListener = RPGAbility && RPGAbility->bUseFastEventRouting;
+
+	// A pooled task is still registered from its last use, which is fine if nothing changed
+	if (EventHandle.IsValid())
+	{
+		if (bUsingEventListener == bWantsEventListener && RegisteredEventTags == EventTags)
+		{
+			return;
+		}
+		UnbindEventCallback(RPGAbilitySystemComponent);
+	}
+
+	bUsingEventListener = bWantsEventListener;
+	RegisteredEventTags = EventTags;
+	if (bUsingEventListener)
+	{
+		EventHandle = RPGAbilitySystemComponent->AddGameplayEventListener(EventTags, Ability->GetClass(), FRPGGameplayEventDelegate::CreateUObject(this, &URPGAbilityTask_PlayMontageAndWaitForEvent::OnGameplayEventListener));
+	}
+	else
+	{
+		EventHandle = RPGAbilitySystemComponent->AddGameplayEventTagContainerDelegate(EventTags, FGameplayEventTagMulticastDelegate::FDelegate::CreateUObject(this, &URPGAbilityTask_PlayMontageAndWaitForEvent::OnGameplayEvent));
+	}
+}
+
+void URPGAbilityTask_PlayMontageAndWaitForEvent::UnbindEventCallback(URPGAbilitySystemComponent* RPGAbilitySystemComponent)
+{
+	if (RPGAbilitySystemComponent && EventHandle.IsValid())
+	{
+		if (bUsingEventListener)
+		{
+			RPGAbilitySystemComponent->RemoveGameplayEventListener(EventHandle);
+		}
+		else
+		{
+			RPGAbilitySystemComponent->RemoveGameplayEventTagContainerDelegate(RegisteredEventTags, EventHandle);
+		}
+	}
+	EventHandle.Reset();
+}
+
 void URPGAbilityTask_PlayMontageAndWaitForEvent::Activate()
 {
 	if (Ability == nullptr)
@@ -125,7 +243,7 @@ void URPGAbilityTask_PlayMontageAndWaitForEvent::Activate()
 		if (AnimInstance != nullptr)
 		{
 			// Bind to event callback
-			EventHandle = RPGAbilitySystemComponent->AddGameplayEventTagContainerDelegate(EventTags, FGameplayEventTagMulticastDelegate::FDelegate::CreateUObject(this, &URPGAbilityTask_PlayMontageAndWaitForEvent::OnGameplayEvent));
+			BindEventCallback(RPGAbilitySystemComponent);
 
 			if (RPGAbilitySystemComponent->PlayMontage(Ability, Ability->GetCurrentActivationInfo(), MontageToPlay, Rate, StartSection) > 0.f)
 			{
@@ -135,12 +253,18 @@ void URPGAbilityTask_PlayMontageAndWaitForEvent::Activate()
 					return;
 				}
 
-				CancelledHandle = Ability->OnGameplayAbilityCancelled.AddUObject(this, &URPGAbilityTask_PlayMontageAndWaitForEvent::OnAbilityCancelled);
+				// Pooled tasks are still bound from their last use
+				if (!CancelledHandle.IsValid())
+				{
+					CancelledHandle = Ability->OnGameplayAbilityCancelled.AddUObject(this, &URPGAbilityTask_PlayMontageAndWaitForEvent::OnAbilityCancelled);
+				}
 
-				BlendingOutDelegate.BindUObject(this, &URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageBlendingOut);
+				// Bound with the serial of this use, so callbacks from the montage of an earlier use are ignored
+				ActivationSerial++;
+				BlendingOutDelegate.BindUObject(this, &URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageBlendingOut, ActivationSerial);
 				AnimInstance->Montage_SetBlendingOutDelegate(BlendingOutDelegate, MontageToPlay);
 
-				MontageEndedDelegate.BindUObject(this, &URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageEnded);
+				MontageEndedDelegate.BindUObject(this, &URPGAbilityTask_PlayMontageAndWaitForEvent::OnMontageEnded, ActivationSerial);
 				AnimInstance->Montage_SetEndDelegate(MontageEndedDelegate, MontageToPlay);
 
 				ACharacter* Character = Cast<ACharacter>(GetAvatarActor());
@@ -189,24 +313,68 @@ void URPGAbilityTask_PlayMontageAndWaitForEvent::OnDestroy(bool AbilityEnded)
 	// Note: Clearing montage end delegate isn't necessary since its not a multicast and will be cleared when the next montage plays.
 	// (If we are destroyed, it will detect this and not do anything)
 
-	// This delegate, however, should be cleared as it is a multicast
+	// This delegate, however, should be cleared as it is a multicast. Pooled tasks keep it and ignore it while pooled
 	if (Ability)
 	{
-		Ability->OnGameplayAbilityCancelled.Remove(CancelledHandle);
+		if (!bPooled)
+		{
+			Ability->OnGameplayAbilityCancelled.Remove(CancelledHandle);
+			CancelledHandle.Reset();
+		}
 		if (AbilityEnded && bStopWhenAbilityEnds)
 		{
 			StopPlayingMontage();
 		}
 	}
 
-	URPGAbilitySystemComponent* RPGAbilitySystemComponent = GetTargetASC();
-	if (RPGAbilitySystemComponent)
+	if (!bPooled)
 	{
-		RPGAbilitySystemComponent->RemoveGameplayEventTagContainerDelegate(EventTags, EventHandle);
+		UnbindEventCallback(GetTargetASC());
+	}
+	else
+	{
+		// A pooled task is not pending kill, so nothing else stops a montage still blending out from calling into its next use
+		UnbindMontageDelegates();
 	}
 
 	Super::OnDestroy(AbilityEnded);
 
+	if (bPooled)
+	{
+		// Super marks the task for destruction, a pooled task lives on with its ability instead
+		ClearPendingKill();
+		if (URPGGameplayAbility* RPGAbility = Cast<URPGGameplayAbility>(Ability))
+		{
+			RPGAbility->ReturnPooledMontageTask(this);
+		}
+	}
+
+}
+
+void URPGAbilityTask_PlayMontageAndWaitForEvent::UnbindMontageDelegates()
+{
+	const FGameplayAbilityActorInfo* ActorInfo = Ability ? Ability->GetCurrentActorInfo() : nullptr;
+	UAnimInstance* AnimInstance = ActorInfo ? ActorInfo->GetAnimInstance() : nullptr;
+	if (!AnimInstance)
+	{
+		return;
+	}
+
+	// Check every instance, the one of an earlier use may be blending out behind the active one
+	for (FAnimMontageInstance* MontageInstance : AnimInstance->MontageInstances)
+	{
+		if (MontageInstance)
+		{
+			if (MontageInstance->OnMontageBlendingOutStarted.IsBoundToObject(this))
+			{
+				MontageInstance->OnMontageBlendingOutStarted.Unbind();
+			}
+			if (MontageInstance->OnMontageEnded.IsBoundToObject(this))
+			{
+				MontageInstance->OnMontageEnded.Unbind();
+			}
+		}
+	}
 }
 
 bool URPGAbilityTask_PlayMontageAndWaitForEvent::StopPlayingMontage()
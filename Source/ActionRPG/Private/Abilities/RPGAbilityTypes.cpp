@@ -14,18 +14,169 @@ bool FRPGGameplayEffectContainerSpec::HasValidTargets() const
 	return TargetData.Num() > 0;
 }
 
+/** Actors without hit results all go into one actor array */
+static void AddTargetActors(FGameplayAbilityTargetDataHandle& TargetData, const TArray<AActor*>& TargetActors)
+{
+	if (TargetActors.Num() > 0)
+	{
+		FGameplayAbilityTargetData_ActorArray* NewData = new FGameplayAbilityTargetData_ActorArray();
+		NewData->TargetActorArray.Append(TargetActors);
+		TargetData.Add(NewData);
+	}
+}
+
 void FRPGGameplayEffectContainerSpec::AddTargets(const TArray<FHitResult>& HitResults, const TArray<AActor*>& TargetActors)
 {
+	if (HitResults.Num() > 0)
+	{
+		TSharedPtr<FRPGGameplayAbilityTargetData_MultiHit> NewData = FRPGGameplayAbilityTargetData_MultiHit::Allocate();
+		NewData->HitResults.Append(HitResults);
+		TargetData.Data.Add(NewData);
+	}
+
+	AddTargetActors(TargetData, TargetActors);
+}
+
+void FRPGGameplayEffectContainerSpec::AddTargets(TArray<FHitResult>&& HitResults, const TArray<AActor*>& TargetActors)
+{
+	if (HitResults.Num() > 0)
+	{
+		TSharedPtr<FRPGGameplayAbilityTargetData_MultiHit> NewData = FRPGGameplayAbilityTargetData_MultiHit::Allocate();
+		NewData->HitResults = MoveTemp(HitResults);
+		TargetData.Data.Add(NewData);
+	}
+
+	AddTargetActors(TargetData, TargetActors);
+}
+
+namespace RPGTargetDataPool
+{
+	/** Most instances kept around, enough for every ability in flight on a busy frame */
+	static const int32 MaxPooled = 64;
+
+	/** Hit arrays that grew past this are freed instead of pooled, so one huge sweep doesn't pin its memory */
+	static const int32 MaxPooledHits = 128;
+
+	struct FPool
+	{
+		TArray<FRPGGameplayAbilityTargetData_MultiHit*> FreeList;
+
+		~FPool()
+		{
+			for (FRPGGameplayAbilityTargetData_MultiHit* TargetData : FreeList)
+			{
+				delete TargetData;
+			}
+		}
+	};
+
+	static FPool& Get()
+	{
+		static FPool Pool;
+		return Pool;
+	}
+}
+
+TSharedPtr<FRPGGameplayAbilityTargetData_MultiHit> FRPGGameplayAbilityTargetData_MultiHit::Allocate()
+{
+	FRPGGameplayAbilityTargetData_MultiHit* TargetData = nullptr;
+
+	// Target data is made on the game thread, anything else just allocates
+	if (IsInGameThread() && RPGTargetDataPool::Get().FreeList.Num() > 0)
+	{
+		TargetData = RPGTargetDataPool::Get().FreeList.Pop(false);
+	}
+	else
+	{
+		TargetData = new FRPGGameplayAbilityTargetData_MultiHit();
+	}
+
+	return TSharedPtr<FRPGGameplayAbilityTargetData_MultiHit>(TargetData, &FRPGGameplayAbilityTargetData_MultiHit::ReturnToPool);
+}
+
+void FRPGGameplayAbilityTargetData_MultiHit::ReturnToPool(FRPGGameplayAbilityTargetData_MultiHit* TargetData)
+{
+	RPGTargetDataPool::FPool& Pool = RPGTargetDataPool::Get();
+	if (IsInGameThread() && Pool.FreeList.Num() < RPGTargetDataPool::MaxPooled && TargetData->HitResults.Max() <= RPGTargetDataPool::MaxPooledHits)
+	{
+		// Keep the hit array allocation for the next sweep
+		TargetData->HitResults.Reset();
+		Pool.FreeList.Add(TargetData);
+	}
+	else
+	{
+		delete TargetData;
+	}
+}
+
+TArray<TWeakObjectPtr<AActor>> FRPGGameplayAbilityTargetData_MultiHit::GetActors() const
+{
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	Actors.Reserve(HitResults.Num());
 	for (const FHitResult& HitResult : HitResults)
 	{
-		FGameplayAbilityTargetData_SingleTargetHit* NewData = new FGameplayAbilityTargetData_SingleTargetHit(HitResult);
-		TargetData.Add(NewData);
+		if (HitResult.Actor.IsValid())
+		{
+			Actors.Add(HitResult.Actor);
+		}
 	}
+	return Actors;
+}
 
-	if (TargetActors.Num() > 0)
+bool FRPGGameplayAbilityTargetData_MultiHit::HasHitResult() const
+{
+	return HitResults.Num() > 0;
+}
+
+const FHitResult* FRPGGameplayAbilityTargetData_MultiHit::GetHitResult() const
+{
+	// Callers that only understand a single hit get the first one
+	return HitResults.Num() > 0 ? &HitResults[0] : nullptr;
+}
+
+TArray<FActiveGameplayEffectHandle> FRPGGameplayAbilityTargetData_MultiHit::ApplyGameplayEffectSpec(FGameplayEffectSpec& InSpec, FPredictionKey PredictionKey)
+{
+	TArray<FActiveGameplayEffectHandle> AppliedHandles;
+
+	UAbilitySystemComponent* InstigatorAbilitySystem = InSpec.GetContext().GetInstigatorAbilitySystemComponent();
+	if (!ensure(InSpec.GetContext().IsValid() && InstigatorAbilitySystem))
 	{
-		FGameplayAbilityTargetData_ActorArray* NewData = new FGameplayAbilityTargetData_ActorArray();
-		NewData->TargetActorArray.Append(TargetActors);
-		TargetData.Add(NewData);
+		return AppliedHandles;
+	}
+
+	AppliedHandles.Reserve(HitResults.Num());
+	for (const FHitResult& HitResult : HitResults)
+	{
+		UAbilitySystemComponent* TargetComponent = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(HitResult.GetActor());
+		if (TargetComponent)
+		{
+			// Each hit gets its own spec and context, otherwise hit results accumulate on the shared context
+			// The context gets the hit actor and hit result, as AddTargetDataToContext does for a single hit
+			FGameplayEffectSpec SpecToApply(InSpec);
+			FGameplayEffectContextHandle EffectContext = SpecToApply.GetContext().Duplicate();
+			EffectContext.AddActors({ HitResult.Actor }, false);
+			EffectContext.AddHitResult(HitResult, true);
+			SpecToApply.SetContext(EffectContext);
+
+			AppliedHandles.Add(InstigatorAbilitySystem->ApplyGameplayEffectSpecToTarget(SpecToApply, TargetComponent, PredictionKey));
+		}
 	}
-}
\ No newline at end of file
+
+	return AppliedHandles;
+}
+
+UScriptStruct* FRPGGameplayAbilityTargetData_MultiHit::GetScriptStruct() const
+{
+	return FRPGGameplayAbilityTargetData_MultiHit::StaticStruct();
+}
+
+FString FRPGGameplayAbilityTargetData_MultiHit::ToString() const
+{
+	return FString::Printf(TEXT("FRPGGameplayAbilityTargetData_MultiHit (%d hits)"), HitResults.Num());
+}
+
+bool FRPGGameplayAbilityTargetData_MultiHit::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = SafeNetSerializeTArray_WithNetSerialize<255>(Ar, HitResults, Map);
+	return true;
+}
@@ -3,6 +3,7 @@
 #include "Abilities/RPGAttributeSet.h"
 #include "Abilities/RPGAbilitySystemComponent.h"
 #include "RPGCharacterBase.h"
+#include "RPGDamageEventSubsystem.h"
 #include "GameplayEffect.h"
 #include "GameplayEffectExtension.h"
 
@@ -31,6 +32,27 @@ void URPGAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
 	DOREPLIFETIME(URPGAttributeSet, MoveSpeed);
 }
 
+void URPGAttributeSet::ResetAttributesToDefaults()
+{
+	UAbilitySystemComponent* AbilityComp = GetOwningAbilitySystemComponent();
+	if (!AbilityComp)
+	{
+		return;
+	}
+
+	const URPGAttributeSet* Defaults = GetClass()->GetDefaultObject<URPGAttributeSet>();
+
+	// Max values first, otherwise PreAttributeChange rescales the current values after they are set
+	AbilityComp->SetNumericAttributeBase(GetMaxHealthAttribute(), Defaults->GetMaxHealth());
+	AbilityComp->SetNumericAttributeBase(GetMaxManaAttribute(), Defaults->GetMaxMana());
+	AbilityComp->SetNumericAttributeBase(GetHealthAttribute(), Defaults->GetHealth());
+	AbilityComp->SetNumericAttributeBase(GetManaAttribute(), Defaults->GetMana());
+	AbilityComp->SetNumericAttributeBase(GetAttackPowerAttribute(), Defaults->GetAttackPower());
+	AbilityComp->SetNumericAttributeBase(GetDefensePowerAttribute(), Defaults->GetDefensePower());
+	AbilityComp->SetNumericAttributeBase(GetMoveSpeedAttribute(), Defaults->GetMoveSpeed());
+	AbilityComp->SetNumericAttributeBase(GetDamageAttribute(), Defaults->GetDamage());
+}
+
 void URPGAttributeSet::OnRep_Health(const FGameplayAttributeData& OldValue)
 {
 	GAMEPLAYATTRIBUTE_REPNOTIFY(URPGAttributeSet, Health, OldValue);
@@ -113,57 +135,15 @@ void URPGAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbac
 
 	// Get the Target actor, which should be our owner
 	AActor* TargetActor = nullptr;
-	AController* TargetController = nullptr;
 	ARPGCharacterBase* TargetCharacter = nullptr;
 	if (Data.Target.AbilityActorInfo.IsValid() && Data.Target.AbilityActorInfo->AvatarActor.IsValid())
 	{
 		TargetActor = Data.Target.AbilityActorInfo->AvatarActor.Get();
-		TargetController = Data.Target.AbilityActorInfo->PlayerController.Get();
 		TargetCharacter = Cast<ARPGCharacterBase>(TargetActor);
 	}
 
 	if (Data.EvaluatedData.Attribute == GetDamageAttribute())
 	{
-		// Get the Source actor
-		AActor* SourceActor = nullptr;
-		AController* SourceController = nullptr;
-		ARPGCharacterBase* SourceCharacter = nullptr;
-		if (Source && Source->AbilityActorInfo.IsValid() && Source->AbilityActorInfo->AvatarActor.IsValid())
-		{
-			SourceActor = Source->AbilityActorInfo->AvatarActor.Get();
-			SourceController = Source->AbilityActorInfo->PlayerController.Get();
-			if (SourceController == nullptr && SourceActor != nullptr)
-			{
-				if (APawn* Pawn = Cast<APawn>(SourceActor))
-				{
-					SourceController = Pawn->GetController();
-				}
-			}
-
-			// Use the controller to find the source pawn
-			if (SourceController)
-			{
-				SourceCharacter = Cast<ARPGCharacterBase>(SourceController->GetPawn());
-			}
-			else
-			{
-				SourceCharacter = Cast<ARPGCharacterBase>(SourceActor);
-			}
-
-			// Set the causer actor based on context if it's set
-			if (Context.GetEffectCauser())
-			{
-				SourceActor = Context.GetEffectCauser();
-			}
-		}
-
-		// Try to extract a hit result
-		FHitResult HitResult;
-		if (Context.GetHitResult())
-		{
-			HitResult = *Context.GetHitResult();
-		}
-
 		// Store a local copy of the amount of damage done and clear the damage attribute
 		const float LocalDamageDone = GetDamage();
 		SetDamage(0.f);
@@ -174,13 +154,67 @@ void URPGAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbac
 			const float OldHealth = GetHealth();
 			SetHealth(FMath::Clamp(OldHealth - LocalDamageDone, 0.0f, GetMaxHealth()));
 
+			// Only resolve the source if someone is going to be told about the damage
 			if (TargetCharacter)
 			{
-				// This is proper damage
-				TargetCharacter->HandleDamage(LocalDamageDone, HitResult, SourceTags, SourceCharacter, SourceActor);
+				// Get the Source actor
+				AActor* SourceActor = nullptr;
+				ARPGCharacterBase* SourceCharacter = nullptr;
+				if (Source && Source->AbilityActorInfo.IsValid() && Source->AbilityActorInfo->AvatarActor.IsValid())
+				{
+					SourceActor = Source->AbilityActorInfo->AvatarActor.Get();
+
+					// The avatar is almost always the character itself, only go through the controller when it isn't
+					SourceCharacter = Cast<ARPGCharacterBase>(SourceActor);
+					if (!SourceCharacter)
+					{
+						AController* SourceController = Source->AbilityActorInfo->PlayerController.Get();
+						if (SourceController == nullptr && SourceActor != nullptr)
+						{
+							if (APawn* Pawn = Cast<APawn>(SourceActor))
+							{
+								SourceController = Pawn->GetController();
+							}
+						}
+
+						// Use the controller to find the source pawn
+						if (SourceController)
+						{
+							SourceCharacter = Cast<ARPGCharacterBase>(SourceController->GetPawn());
+						}
+					}
+
+					// Set the causer actor based on context if it's set
+					if (Context.GetEffectCauser())
+					{
+						SourceActor = Context.GetEffectCauser();
+					}
+				}
+
+				// Point at the hit result rather than copying it
+				const FHitResult* HitResult = Context.GetHitResult();
+
+				URPGDamageEventSubsystem* DamageEventSubsystem = TargetCharacter->bBatchDamageEvents ? URPGDamageEventSubsystem::Get(TargetCharacter) : nullptr;
+				if (DamageEventSubsystem)
+				{
+					// Queue a record, the character gets one HandleDamageEvents call for all hits this frame
+					FRPGDamageEvent DamageEvent;
+					DamageEvent.TargetCharacter = TargetCharacter;
+					DamageEvent.InstigatorCharacter = SourceCharacter;
+					DamageEvent.DamageCauser = SourceActor;
+					DamageEvent.DamageAmount = LocalDamageDone;
+					DamageEvent.HitLocation = HitResult ? FVector(HitResult->ImpactPoint) : FVector::ZeroVector;
+					DamageEvent.DamageTags = SourceTags;
+					DamageEventSubsystem->QueueDamageEvent(MoveTemp(DamageEvent));
+				}
+				else
+				{
+					// This is proper damage
+					TargetCharacter->HandleDamage(LocalDamageDone, HitResult ? *HitResult : FHitResult(), SourceTags, SourceCharacter, SourceActor);
 
-				// Call for all health changes
-				TargetCharacter->HandleHealthChanged(-LocalDamageDone, SourceTags);
+					// Call for all health changes
+					TargetCharacter->HandleHealthChanged(-LocalDamageDone, SourceTags);
+				}
 			}
 		}
 	}
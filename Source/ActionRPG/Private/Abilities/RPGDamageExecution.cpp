@@ -3,6 +3,8 @@
 #include "Abilities/RPGDamageExecution.h"
 #include "Abilities/RPGAttributeSet.h"
 #include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Abilities/GameplayAbilityTargetTypes.h"
 
 struct RPGDamageStatics
 {
@@ -61,22 +63,123 @@ void URPGDamageExecution::Execute_Implementation(const FGameplayEffectCustomExec
 	//	If DefensePower is 0, it is treated as 1.0
 	// --------------------------------------
 
-	float DefensePower = 0.f;
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().DefensePowerDef, EvaluationParameters, DefensePower);
-	if (DefensePower == 0.0f)
+	float DamageDone = 0.f;
+	FRPGScopedDamageBatch* DamageBatch = FRPGScopedDamageBatch::GetActive();
+	if (!DamageBatch || !DamageBatch->FindDamageDone(ExecutionParams, EvaluationParameters, DamageDone))
 	{
-		DefensePower = 1.0f;
+		float DefensePower = 0.f;
+		ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().DefensePowerDef, EvaluationParameters, DefensePower);
+		if (DefensePower == 0.0f)
+		{
+			DefensePower = 1.0f;
+		}
+
+		float AttackPower = 0.f;
+		ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().AttackPowerDef, EvaluationParameters, AttackPower);
+
+		float Damage = 0.f;
+		ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().DamageDef, EvaluationParameters, Damage);
+
+		DamageDone = Damage * AttackPower / DefensePower;
+	}
+
+	if (DamageDone > 0.f)
+	{
+		OutExecutionOutput.AddOutputModifier(FGameplayModifierEvaluatedData(DamageStatics().DamageProperty, EGameplayModOp::Additive, DamageDone));
 	}
+}
+
+FRPGScopedDamageBatch* FRPGScopedDamageBatch::ActiveBatch = nullptr;
+
+FRPGScopedDamageBatch::FRPGScopedDamageBatch(const FGameplayEffectSpec& Spec, const FGameplayAbilityTargetDataHandle& TargetData)
+	: EffectDef(Spec.Def)
+	, EffectLevel(Spec.GetLevel())
+	, InstigatorAbilitySystem(Spec.GetContext().GetInstigatorAbilitySystemComponent())
+	, bComputed(false)
+	, OuterBatch(ActiveBatch)
+{
+	check(IsInGameThread());
+
+	for (const TSharedPtr<FGameplayAbilityTargetData>& Data : TargetData.Data)
+	{
+		if (!Data.IsValid())
+		{
+			continue;
+		}
+
+		for (const TWeakObjectPtr<AActor>& TargetActor : Data->GetActors())
+		{
+			UAbilitySystemComponent* TargetAbilitySystem = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(TargetActor.Get());
+			if (TargetAbilitySystem && !TargetIndices.Contains(TargetAbilitySystem))
+			{
+				TargetIndices.Add(TargetAbilitySystem, Targets.Add(TargetAbilitySystem));
+			}
+		}
+	}
+
+	ActiveBatch = this;
+}
+
+FRPGScopedDamageBatch::~FRPGScopedDamageBatch()
+{
+	check(ActiveBatch == this);
+	ActiveBatch = OuterBatch;
+}
+
+FRPGScopedDamageBatch* FRPGScopedDamageBatch::GetActive()
+{
+	return ActiveBatch;
+}
 
+bool FRPGScopedDamageBatch::FindDamageDone(const FGameplayEffectCustomExecutionParameters& ExecutionParams, const FAggregatorEvaluateParameters& EvaluationParameters, float& OutDamageDone)
+{
+	const FGameplayEffectSpec& Spec = ExecutionParams.GetOwningSpec();
+	if (Spec.Def != EffectDef || Spec.GetLevel() != EffectLevel || Spec.GetContext().GetInstigatorAbilitySystemComponent() != InstigatorAbilitySystem)
+	{
+		return false;
+	}
+
+	const int32* TargetIndex = TargetIndices.Find(ExecutionParams.GetTargetAbilitySystemComponent());
+	if (!TargetIndex)
+	{
+		return false;
+	}
+
+	// Done on the first execution rather than when the batch opens, so DefensePower is read when the spec actually lands
+	if (!bComputed)
+	{
+		ComputeDamage(ExecutionParams, EvaluationParameters);
+	}
+
+	OutDamageDone = TargetDamage[*TargetIndex];
+	return true;
+}
+
+void FRPGScopedDamageBatch::ComputeDamage(const FGameplayEffectCustomExecutionParameters& ExecutionParams, const FAggregatorEvaluateParameters& EvaluationParameters)
+{
+	bComputed = true;
+
+	// Source side is snapshotted on the spec, so it is the same for every target
 	float AttackPower = 0.f;
 	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().AttackPowerDef, EvaluationParameters, AttackPower);
 
 	float Damage = 0.f;
 	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().DamageDef, EvaluationParameters, Damage);
 
-	float DamageDone = Damage * AttackPower / DefensePower;
-	if (DamageDone > 0.f)
+	const float SourceDamage = Damage * AttackPower;
+
+	// Gather into one contiguous array, then one branch free loop over it that the compiler can vectorize
+	const int32 NumTargets = Targets.Num();
+	TargetDamage.SetNumUninitialized(NumTargets);
+	for (int32 Index = 0; Index < NumTargets; Index++)
 	{
-		OutExecutionOutput.AddOutputModifier(FGameplayModifierEvaluatedData(DamageStatics().DamageProperty, EGameplayModOp::Additive, DamageDone));
+		TargetDamage[Index] = Targets[Index] ? Targets[Index]->GetNumericAttribute(URPGAttributeSet::GetDefensePowerAttribute()) : 0.f;
 	}
-}
\ No newline at end of file
+
+	float* RESTRICT Values = TargetDamage.GetData();
+	for (int32 Index = 0; Index < NumTargets; Index++)
+	{
+		const float DefensePower = Values[Index] == 0.f ? 1.f : Values[Index];
+		Values[Index] = SourceDamage / DefensePower;
+	}
+}
@@ -3,31 +3,47 @@
 #include "Abilities/RPGGameplayAbility.h"
 #include "Abilities/RPGAbilitySystemComponent.h"
 #include "Abilities/RPGTargetType.h"
+#include "Abilities/RPGDamageExecution.h"
+#include "Abilities/RPGAbilityTask_PlayMontageAndWaitForEvent.h"
 #include "RPGCharacterBase.h"
 
-URPGGameplayAbility::URPGGameplayAbility() {}
+URPGGameplayAbility::URPGGameplayAbility()
+	: bBatchDamageExecution(false)
+	, bUseFastEventRouting(false)
+	, bPoolMontageTasks(false)
+{}
 
-FRPGGameplayEffectContainerSpec URPGGameplayAbility::MakeEffectContainerSpecFromContainer(const FRPGGameplayEffectContainer& Container, const FGameplayEventData& EventData, int32 OverrideGameplayLevel)
+bool URPGGameplayAbility::AddContainerTargets(const FRPGGameplayEffectContainer& Container, const FGameplayEventData& EventData, FRPGGameplayEffectContainerSpec& OutSpec)
 {
 	// First figure out our actor info
-	FRPGGameplayEffectContainerSpec ReturnSpec;
 	AActor* OwningActor = GetOwningActorFromActorInfo();
 	ARPGCharacterBase* OwningCharacter = Cast<ARPGCharacterBase>(OwningActor);
 	URPGAbilitySystemComponent* OwningASC = URPGAbilitySystemComponent::GetAbilitySystemComponentFromActor(OwningActor);
 
-	if (OwningASC)
+	if (!OwningASC)
 	{
-		// If we have a target type, run the targeting logic. This is optional, targets can be added later
-		if (Container.TargetType.Get())
-		{
-			TArray<FHitResult> HitResults;
-			TArray<AActor*> TargetActors;
-			const URPGTargetType* TargetTypeCDO = Container.TargetType.GetDefaultObject();
-			AActor* AvatarActor = GetAvatarActorFromActorInfo();
-			TargetTypeCDO->GetTargets(OwningCharacter, AvatarActor, EventData, HitResults, TargetActors);
-			ReturnSpec.AddTargets(HitResults, TargetActors);
-		}
+		return false;
+	}
+
+	// If we have a target type, run the targeting logic. This is optional, targets can be added later
+	if (Container.TargetType.Get())
+	{
+		TArray<FHitResult> HitResults;
+		TArray<AActor*> TargetActors;
+		const URPGTargetType* TargetTypeCDO = Container.TargetType.GetDefaultObject();
+		AActor* AvatarActor = GetAvatarActorFromActorInfo();
+		TargetTypeCDO->GetTargets(OwningCharacter, AvatarActor, EventData, HitResults, TargetActors);
+		OutSpec.AddTargets(MoveTemp(HitResults), TargetActors);
+	}
+	return true;
+}
 
+FRPGGameplayEffectContainerSpec URPGGameplayAbility::MakeEffectContainerSpecFromContainer(const FRPGGameplayEffectContainer& Container, const FGameplayEventData& EventData, int32 OverrideGameplayLevel)
+{
+	FRPGGameplayEffectContainerSpec ReturnSpec;
+
+	if (AddContainerTargets(Container, EventData, ReturnSpec))
+	{
 		// If we don't have an override level, use the default on the ability itself
 		if (OverrideGameplayLevel == INDEX_NONE)
 		{
@@ -45,13 +61,99 @@ FRPGGameplayEffectContainerSpec URPGGameplayAbility::MakeEffectContainerSpecFrom
 
 FRPGGameplayEffectContainerSpec URPGGameplayAbility::MakeEffectContainerSpec(FGameplayTag ContainerTag, const FGameplayEventData& EventData, int32 OverrideGameplayLevel)
 {
-	FRPGGameplayEffectContainer* FoundContainer = EffectContainerMap.Find(ContainerTag);
+	// Other instancing policies have no state that outlives one activation, so they build from scratch
+	if (GetInstancingPolicy() != EGameplayAbilityInstancingPolicy::InstancedPerActor)
+	{
+		FRPGGameplayEffectContainer* FoundContainer = EffectContainerMap.Find(ContainerTag);
+
+		if (FoundContainer)
+		{
+			return MakeEffectContainerSpecFromContainer(*FoundContainer, EventData, OverrideGameplayLevel);
+		}
+		return FRPGGameplayEffectContainerSpec();
+	}
 
-	if (FoundContainer)
+	if (OverrideGameplayLevel == INDEX_NONE)
 	{
-		return MakeEffectContainerSpecFromContainer(*FoundContainer, EventData, OverrideGameplayLevel);
+		OverrideGameplayLevel = GetAbilityLevel();
+	}
+
+	FRPGGameplayEffectContainerSpec ReturnSpec;
+	bool bAdded = false;
+	FCachedContainerSpec* CachedSpec = FindOrAddCachedContainerSpec(ContainerTag, OverrideGameplayLevel, bAdded);
+
+	if (CachedSpec && AddContainerTargets(*CachedSpec->Container, EventData, ReturnSpec))
+	{
+		for (int32 Index = 0; Index < CachedSpec->Handles.Num(); Index++)
+		{
+			FGameplayEffectSpecHandle& Handle = CachedSpec->Handles[Index];
+
+			// Freshly made specs are already current
+			if (!bAdded && Handle.IsValid())
+			{
+				if (Handle.Data.IsUnique())
+				{
+					*Handle.Data = CachedSpec->Templates[Index];
+				}
+				else
+				{
+					// Still held by something like a projectile, leave that one alone
+					Handle = FGameplayEffectSpecHandle(new FGameplayEffectSpec(CachedSpec->Templates[Index]));
+				}
+				RefreshCachedSpec(*Handle.Data);
+			}
+			ReturnSpec.TargetGameplayEffectSpecs.Add(Handle);
+		}
+	}
+	return ReturnSpec;
+}
+
+URPGGameplayAbility::FCachedContainerSpec* URPGGameplayAbility::FindOrAddCachedContainerSpec(FGameplayTag ContainerTag, int32 Level, bool& bOutAdded)
+{
+	bOutAdded = false;
+
+	// Abilities have a handful of containers, a linear search beats hashing the tag
+	for (FCachedContainerSpec& CachedSpec : CachedContainerSpecs)
+	{
+		if (CachedSpec.ContainerTag == ContainerTag && CachedSpec.Level == Level)
+		{
+			return &CachedSpec;
+		}
+	}
+
+	const FRPGGameplayEffectContainer* FoundContainer = EffectContainerMap.Find(ContainerTag);
+	if (!FoundContainer || !CurrentActorInfo)
+	{
+		return nullptr;
+	}
+
+	FCachedContainerSpec& CachedSpec = CachedContainerSpecs.AddDefaulted_GetRef();
+	CachedSpec.ContainerTag = ContainerTag;
+	CachedSpec.Level = Level;
+	CachedSpec.Container = FoundContainer;
+
+	for (const TSubclassOf<UGameplayEffect>& EffectClass : FoundContainer->TargetGameplayEffectClasses)
+	{
+		FGameplayEffectSpecHandle Handle = MakeOutgoingGameplayEffectSpec(EffectClass, Level);
+		CachedSpec.Templates.Add(Handle.IsValid() ? *Handle.Data : FGameplayEffectSpec());
+		CachedSpec.Handles.Add(Handle);
+	}
+
+	bOutAdded = true;
+	return &CachedSpec;
+}
+
+void URPGGameplayAbility::RefreshCachedSpec(FGameplayEffectSpec& Spec) const
+{
+	// Setting a new context on an initialized spec also recaptures the source tags and snapshotted source attributes
+	Spec.SetContext(MakeEffectContext(CurrentSpecHandle, CurrentActorInfo));
+
+	FGameplayAbilitySpec* AbilitySpec = GetCurrentAbilitySpec();
+	ApplyAbilityTagsToGameplayEffectSpec(Spec, AbilitySpec);
+	if (AbilitySpec)
+	{
+		Spec.SetByCallerTagMagnitudes = AbilitySpec->SetByCallerTagMagnitudes;
 	}
-	return FRPGGameplayEffectContainerSpec();
 }
 
 TArray<FActiveGameplayEffectHandle> URPGGameplayAbility::ApplyEffectContainerSpec(const FRPGGameplayEffectContainerSpec& ContainerSpec)
@@ -61,7 +163,15 @@ TArray<FActiveGameplayEffectHandle> URPGGameplayAbility::ApplyEffectContainerSpe
 	// Iterate list of effect specs and apply them to their target data
 	for (const FGameplayEffectSpecHandle& SpecHandle : ContainerSpec.TargetGameplayEffectSpecs)
 	{
-		AllEffects.Append(K2_ApplyGameplayEffectSpecToTarget(SpecHandle, ContainerSpec.TargetData));
+		if (bBatchDamageExecution && SpecHandle.IsValid())
+		{
+			FRPGScopedDamageBatch DamageBatch(*SpecHandle.Data.Get(), ContainerSpec.TargetData);
+			AllEffects.Append(K2_ApplyGameplayEffectSpecToTarget(SpecHandle, ContainerSpec.TargetData));
+		}
+		else
+		{
+			AllEffects.Append(K2_ApplyGameplayEffectSpecToTarget(SpecHandle, ContainerSpec.TargetData));
+		}
 	}
 	return AllEffects;
 }
@@ -71,3 +181,33 @@ TArray<FActiveGameplayEffectHandle> URPGGameplayAbility::ApplyEffectContainer(FG
 	FRPGGameplayEffectContainerSpec Spec = MakeEffectContainerSpec(ContainerTag, EventData, OverrideGameplayLevel);
 	return ApplyEffectContainerSpec(Spec);
 }
+
+bool URPGGameplayAbility::ShouldPoolMontageTasks() const
+{
+	return bPoolMontageTasks && GetInstancingPolicy() == EGameplayAbilityInstancingPolicy::InstancedPerActor;
+}
+
+URPGAbilityTask_PlayMontageAndWaitForEvent* URPGGameplayAbility::TakePooledMontageTask()
+{
+	return PooledMontageTasks.Num() > 0 ? PooledMontageTasks.Pop(false) : nullptr;
+}
+
+void URPGGameplayAbility::ReturnPooledMontageTask(URPGAbilityTask_PlayMontageAndWaitForEvent* Task)
+{
+	PooledMontageTasks.AddUnique(Task);
+}
+
+void URPGGameplayAbility::OnRemoveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec)
+{
+	// Pooled tasks keep their callbacks bound, drop those along with the ability
+	for (URPGAbilityTask_PlayMontageAndWaitForEvent* Task : PooledMontageTasks)
+	{
+		if (Task)
+		{
+			Task->ReleaseFromPool();
+		}
+	}
+	PooledMontageTasks.Reset();
+
+	Super::OnRemoveAbility(ActorInfo, Spec);
+}
@@ -0,0 +1,75 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Abilities/RPGGameplayEventRegistry.h"
+
+FRPGGameplayEventTagRegistry& FRPGGameplayEventTagRegistry::Get()
+{
+	static FRPGGameplayEventTagRegistry Registry;
+	return Registry;
+}
+
+uint64 FRPGGameplayEventTagRegistry::CompileFilter(const UClass* OwnerClass, const FGameplayTagContainer& FilterTags, bool& bOutExact)
+{
+	check(IsInGameThread());
+
+	TArray<FCompiledFilter, TInlineAllocator<2>>& Filters = ClassFilters.FindOrAdd(FObjectKey(OwnerClass));
+	for (const FCompiledFilter& Filter : Filters)
+	{
+		if (Filter.FilterTags == FilterTags)
+		{
+			bOutExact = Filter.bExact;
+			return Filter.Mask;
+		}
+	}
+
+	FCompiledFilter& Filter = Filters.AddDefaulted_GetRef();
+	Filter.FilterTags = FilterTags;
+	Filter.Mask = 0;
+	Filter.bExact = true;
+
+	for (const FGameplayTag& Tag : FilterTags)
+	{
+		int32* Bit = TagBits.Find(Tag);
+		if (!Bit && TagBits.Num() < 64)
+		{
+			Bit = &TagBits.Add(Tag, TagBits.Num());
+
+			// Events already cached may match the new tag
+			EventMasks.Reset();
+		}
+
+		if (Bit)
+		{
+			Filter.Mask |= 1ull << *Bit;
+		}
+		else
+		{
+			Filter.bExact = false;
+		}
+	}
+
+	bOutExact = Filter.bExact;
+	return Filter.Mask;
+}
+
+uint64 FRPGGameplayEventTagRegistry::GetEventMask(const FGameplayTag& EventTag)
+{
+	check(IsInGameThread());
+
+	if (const uint64* CachedMask = EventMasks.Find(EventTag))
+	{
+		return *CachedMask;
+	}
+
+	uint64 Mask = 0;
+	for (const TPair<FGameplayTag, int32>& TagBit : TagBits)
+	{
+		if (EventTag.MatchesTag(TagBit.Key))
+		{
+			Mask |= 1ull << TagBit.Value;
+		}
+	}
+
+	EventMasks.Add(EventTag, Mask);
+	return Mask;
+}
@@ -3,6 +3,8 @@
 #include "Abilities/RPGTargetType.h"
 #include "Abilities/RPGGameplayAbility.h"
 #include "RPGCharacterBase.h"
+#include "RPGSpatialHashSubsystem.h"
+#include "Components/CapsuleComponent.h"
 
 void URPGTargetType::GetTargets_Implementation(ARPGCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
 {
@@ -25,4 +27,80 @@ void URPGTargetType_UseEventData::GetTargets_Implementation(ARPGCharacterBase* T
 	{
 		OutActors.Add(const_cast<AActor*>(EventData.Target));
 	}
-}
\ No newline at end of file
+}
+
+URPGTargetType_SpatialQuery::URPGTargetType_SpatialQuery()
+	: Offset(ForceInit)
+	, bIgnoreTargetingCharacter(true)
+	, bIgnoreSameSide(true)
+{
+}
+
+void URPGTargetType_SpatialQuery::GetTargets_Implementation(ARPGCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+{
+	AActor* SourceActor = TargetingActor ? TargetingActor : TargetingCharacter;
+	URPGSpatialHashSubsystem* SpatialHash = URPGSpatialHashSubsystem::Get(SourceActor);
+	if (!SpatialHash)
+	{
+		return;
+	}
+
+	const FTransform& SourceTransform = SourceActor->GetActorTransform();
+	const FVector Origin = SourceTransform.TransformPosition(Offset);
+	const FVector Forward = SourceTransform.GetUnitAxis(EAxis::X);
+
+	TArray<ARPGCharacterBase*> Characters;
+	QueryCharacters(SpatialHash, Origin, Forward, Characters);
+
+	const bool bSourceIsPlayer = TargetingCharacter && TargetingCharacter->IsPlayerControlled();
+	OutHitResults.Reserve(OutHitResults.Num() + Characters.Num());
+
+	for (ARPGCharacterBase* Character : Characters)
+	{
+		if (bIgnoreTargetingCharacter && Character == TargetingCharacter)
+		{
+			continue;
+		}
+		if (bIgnoreSameSide && TargetingCharacter && Character->IsPlayerControlled() == bSourceIsPlayer)
+		{
+			continue;
+		}
+
+		// Hit the character where a trace from the origin would, facing back at the origin
+		const FVector Location = Character->GetActorLocation();
+		const FVector Normal = (Origin - Location).GetSafeNormal2D();
+		OutHitResults.Emplace(Character, Character->GetCapsuleComponent(), Location, Normal);
+	}
+}
+
+URPGTargetType_Sphere::URPGTargetType_Sphere()
+	: Radius(300.f)
+{
+}
+
+void URPGTargetType_Sphere::QueryCharacters(URPGSpatialHashSubsystem* SpatialHash, const FVector& Origin, const FVector& Forward, TArray<ARPGCharacterBase*>& OutCharacters) const
+{
+	SpatialHash->QuerySphere(Origin, Radius, OutCharacters);
+}
+
+URPGTargetType_Cone::URPGTargetType_Cone()
+	: Length(400.f)
+	, HalfAngle(45.f)
+{
+}
+
+void URPGTargetType_Cone::QueryCharacters(URPGSpatialHashSubsystem* SpatialHash, const FVector& Origin, const FVector& Forward, TArray<ARPGCharacterBase*>& OutCharacters) const
+{
+	SpatialHash->QueryCone(Origin, Forward, Length, HalfAngle, OutCharacters);
+}
+
+URPGTargetType_Capsule::URPGTargetType_Capsule()
+	: Length(600.f)
+	, Radius(100.f)
+{
+}
+
+void URPGTargetType_Capsule::QueryCharacters(URPGSpatialHashSubsystem* SpatialHash, const FVector& Origin, const FVector& Forward, TArray<ARPGCharacterBase*>& OutCharacters) const
+{
+	SpatialHash->QueryCapsule(Origin, Origin + Forward * Length, Radius, OutCharacters);
+}
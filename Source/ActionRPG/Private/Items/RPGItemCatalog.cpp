@@ -0,0 +1,387 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Items/RPGItemCatalog.h"
+#include "Abilities/RPGGameplayAbility.h"
+#include "Engine/DataTable.h"
+
+template<typename ItemStructType>
+void FRPGItemCatalog::BuildType(ERPGItemType ItemType, const TMap<FString, ItemStructType>& InItems, TArray<ItemStructType>& OutItems)
+{
+	const int32 TypeIndex = (int32)ItemType;
+
+	OutItems.Reset(InItems.Num());
+	Keys[TypeIndex].Reset(InItems.Num());
+	SoftReferences[TypeIndex].Reset(InItems.Num());
+	KeyToIndex[TypeIndex].Reset();
+	KeyToIndex[TypeIndex].Reserve(InItems.Num());
+
+	for (const TPair<FString, ItemStructType>& Pair : InItems)
+	{
+		if (Pair.Key.IsEmpty())
+		{
+			UE_LOG(LogActionRPG, Warning, TEXT("FRPGItemCatalog: Skipping item with empty key!"));
+			continue;
+		}
+
+		const FName KeyName(*Pair.Key);
+		const int32 Index = OutItems.Add(Pair.Value);
+
+		// Make sure the stored type always matches the array the item lives in
+		OutItems[Index].ItemType = ItemType;
+
+		Keys[TypeIndex].Add(KeyName);
+		KeyToIndex[TypeIndex].Add(KeyName, Index);
+
+		// Inline items hold hard references, keep the soft reference array parallel with an empty entry
+		SoftReferences[TypeIndex].AddDefaulted();
+	}
+}
+
+void FRPGItemCatalog::AddDefinitionRow(FName ItemKey, const FRPGItemDefinitionRow& Row)
+{
+	if (Row.ItemType >= ERPGItemType::Undefined)
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("FRPGItemCatalog: Skipping row %s with undefined item type!"), *ItemKey.ToString());
+		return;
+	}
+
+	const int32 TypeIndex = (int32)Row.ItemType;
+	if (KeyToIndex[TypeIndex].Contains(ItemKey))
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("FRPGItemCatalog: Skipping row %s, an item with that key already exists!"), *ItemKey.ToString());
+		return;
+	}
+
+	FRPGItemStruct* Item = nullptr;
+	int32 Index = INDEX_NONE;
+	switch (Row.ItemType)
+	{
+	case ERPGItemType::Potion:
+		Index = Potions.AddDefaulted();
+		Item = &Potions[Index];
+		break;
+	case ERPGItemType::Skill:
+		Index = Skills.AddDefaulted();
+		Item = &Skills[Index];
+		break;
+	case ERPGItemType::Token:
+		Index = Tokens.AddDefaulted();
+		Item = &Tokens[Index];
+		break;
+	case ERPGItemType::Weapon:
+		Index = Weapons.AddDefaulted();
+		Item = &Weapons[Index];
+		break;
+	}
+	check(Item);
+
+	Item->ItemName = Row.ItemName;
+	Item->ItemDescription = Row.ItemDescription;
+	Item->ItemIcon = Row.ItemIcon;
+	Item->ItemIcon.SetResourceObject(nullptr);
+	Item->Price = Row.Price;
+	Item->MaxCount = Row.MaxCount;
+	Item->MaxLevel = Row.MaxLevel;
+	Item->AbilityLevel = Row.AbilityLevel;
+
+	FRPGItemSoftReferences& Refs = SoftReferences[TypeIndex].AddDefaulted_GetRef();
+	Refs.ItemIcon = Row.ItemIconResource.ToSoftObjectPath();
+	Refs.GrantedAbility = Row.GrantedAbility.ToSoftObjectPath();
+	if (Row.ItemType == ERPGItemType::Weapon)
+	{
+		Refs.WeaponActor = Row.WeaponActor.ToSoftObjectPath();
+		static_cast<FRPGWeaponItemStruct*>(Item)->PoolPrewarmCount = Row.WeaponPoolPrewarmCount;
+	}
+
+	Keys[TypeIndex].Add(ItemKey);
+	KeyToIndex[TypeIndex].Add(ItemKey, Index);
+
+	// Anything that happens to be in memory already, such as in the editor, can be used straight away
+	ApplyLoadedAssets(FRPGItemId(Row.ItemType, Index));
+}
+
+void FRPGItemCatalog::Build(const TMap<FString, FRPGPotionItemStruct>& InPotions, const TMap<FString, FRPGSkillItemStruct>& InSkills, const TMap<FString, FRPGTokenItemStruct>& InTokens, const TMap<FString, FRPGWeaponItemStruct>& InWeapons, const TArray<const UDataTable*>& DefinitionTables)
+{
+	BuildType(ERPGItemType::Potion, InPotions, Potions);
+	BuildType(ERPGItemType::Skill, InSkills, Skills);
+	BuildType(ERPGItemType::Token, InTokens, Tokens);
+	BuildType(ERPGItemType::Weapon, InWeapons, Weapons);
+
+	// Table rows go after the inline items, so inline definitions win on key clashes
+	for (const UDataTable* Table : DefinitionTables)
+	{
+		if (!Table || !Table->GetRowStruct() || !Table->GetRowStruct()->IsChildOf(FRPGItemDefinitionRow::StaticStruct()))
+		{
+			UE_LOG(LogActionRPG, Warning, TEXT("FRPGItemCatalog: Skipping table %s, it does not use FRPGItemDefinitionRow!"), *GetNameSafe(Table));
+			continue;
+		}
+
+		for (const TPair<FName, uint8*>& RowPair : Table->GetRowMap())
+		{
+			AddDefinitionRow(RowPair.Key, *reinterpret_cast<const FRPGItemDefinitionRow*>(RowPair.Value));
+		}
+	}
+
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		InvalidateBaseInfoViews((ERPGItemType)TypeIndex);
+	}
+
+	// Fingerprint of the id layout, so saved ids can be trusted only while it is unchanged. Name hashes are not stable between runs, so hash the strings
+	Fingerprint = 0;
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		Fingerprint = HashCombine(Fingerprint, (uint32)Keys[TypeIndex].Num());
+		for (const FName& Key : Keys[TypeIndex])
+		{
+			Fingerprint = HashCombine(Fingerprint, FCrc::StrCrc32(*Key.ToString()));
+		}
+	}
+
+	// Build the untyped index last so it can be filled in type order
+	UnifiedIndex.Reset();
+	UnifiedIndex.Reserve(Potions.Num() + Skills.Num() + Tokens.Num() + Weapons.Num());
+
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		const TArray<FName>& TypeKeys = Keys[TypeIndex];
+		for (int32 Index = 0; Index < TypeKeys.Num(); Index++)
+		{
+			if (!UnifiedIndex.Contains(TypeKeys[Index]))
+			{
+				UnifiedIndex.Add(TypeKeys[Index], FRPGItemId((ERPGItemType)TypeIndex, Index));
+			}
+		}
+	}
+}
+
+void FRPGItemCatalog::Reset()
+{
+	Fingerprint = 0;
+	Potions.Reset();
+	Skills.Reset();
+	Tokens.Reset();
+	Weapons.Reset();
+
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		Keys[TypeIndex].Reset();
+		SoftReferences[TypeIndex].Reset();
+		KeyToIndex[TypeIndex].Reset();
+		InvalidateBaseInfoViews((ERPGItemType)TypeIndex);
+	}
+	UnifiedIndex.Reset();
+}
+
+FRPGItemId FRPGItemCatalog::FindItemId(FName ItemKey, ERPGItemType ItemType) const
+{
+	if (ItemKey != NAME_None && ItemType < ERPGItemType::Undefined)
+	{
+		const int32* FoundIndex = KeyToIndex[(int32)ItemType].Find(ItemKey);
+		if (FoundIndex)
+		{
+			return FRPGItemId(ItemType, *FoundIndex);
+		}
+	}
+	return FRPGItemId();
+}
+
+FRPGItemId FRPGItemCatalog::FindAnyItemId(FName ItemKey) const
+{
+	if (ItemKey != NAME_None)
+	{
+		const FRPGItemId* FoundId = UnifiedIndex.Find(ItemKey);
+		if (FoundId)
+		{
+			return *FoundId;
+		}
+	}
+	return FRPGItemId();
+}
+
+FName FRPGItemCatalog::GetItemKey(const FRPGItemId& ItemId) const
+{
+	if (IsValidId(ItemId))
+	{
+		return Keys[(int32)ItemId.ItemType][ItemId.Index];
+	}
+	return NAME_None;
+}
+
+bool FRPGItemCatalog::IsValidId(const FRPGItemId& ItemId) const
+{
+	return ItemId.IsValid() && ItemId.ItemType < ERPGItemType::Undefined && Keys[(int32)ItemId.ItemType].IsValidIndex(ItemId.Index);
+}
+
+int32 FRPGItemCatalog::Num(ERPGItemType ItemType) const
+{
+	return ItemType < ERPGItemType::Undefined ? Keys[(int32)ItemType].Num() : 0;
+}
+
+const FRPGItemStruct* FRPGItemCatalog::GetItem(const FRPGItemId& ItemId) const
+{
+	switch (ItemId.ItemType)
+	{
+	case ERPGItemType::Potion:
+		return GetPotion(ItemId.Index);
+	case ERPGItemType::Skill:
+		return GetSkill(ItemId.Index);
+	case ERPGItemType::Token:
+		return GetToken(ItemId.Index);
+	case ERPGItemType::Weapon:
+		return GetWeapon(ItemId.Index);
+	}
+	return nullptr;
+}
+
+FRPGItemStruct* FRPGItemCatalog::GetMutableItem(const FRPGItemId& ItemId)
+{
+	return const_cast<FRPGItemStruct*>(GetItem(ItemId));
+}
+
+void FRPGItemCatalog::GetUnloadedAssets(const FRPGItemId& ItemId, TArray<FSoftObjectPath>& OutAssets) const
+{
+	const FRPGItemStruct* Item = GetItem(ItemId);
+	if (!Item)
+	{
+		return;
+	}
+
+	const FRPGItemSoftReferences& Refs = SoftReferences[(int32)ItemId.ItemType][ItemId.Index];
+	if (Refs.ItemIcon.IsValid() && !Item->ItemIcon.GetResourceObject())
+	{
+		OutAssets.AddUnique(Refs.ItemIcon);
+	}
+	if (Refs.GrantedAbility.IsValid() && !Item->GrantedAbility)
+	{
+		OutAssets.AddUnique(Refs.GrantedAbility);
+	}
+	if (Refs.WeaponActor.IsValid() && !static_cast<const FRPGWeaponItemStruct*>(Item)->WeaponActor)
+	{
+		OutAssets.AddUnique(Refs.WeaponActor);
+	}
+}
+
+bool FRPGItemCatalog::AreAssetsLoaded(const FRPGItemId& ItemId) const
+{
+	TArray<FSoftObjectPath, TInlineAllocator<3>> UnloadedAssets;
+	GetUnloadedAssets(ItemId, UnloadedAssets);
+	return UnloadedAssets.Num() == 0;
+}
+
+bool FRPGItemCatalog::ApplyLoadedAssets(const FRPGItemId& ItemId)
+{
+	FRPGItemStruct* Item = GetMutableItem(ItemId);
+	if (!Item)
+	{
+		return false;
+	}
+
+	bool bChanged = false;
+	const FRPGItemSoftReferences& Refs = SoftReferences[(int32)ItemId.ItemType][ItemId.Index];
+	if (Refs.ItemIcon.IsValid() && !Item->ItemIcon.GetResourceObject())
+	{
+		if (UObject* Icon = Refs.ItemIcon.ResolveObject())
+		{
+			Item->ItemIcon.SetResourceObject(Icon);
+			bChanged = true;
+		}
+	}
+	if (Refs.GrantedAbility.IsValid() && !Item->GrantedAbility)
+	{
+		UClass* AbilityClass = Cast<UClass>(Refs.GrantedAbility.ResolveObject());
+		if (AbilityClass && AbilityClass->IsChildOf(URPGGameplayAbility::StaticClass()))
+		{
+			Item->GrantedAbility = AbilityClass;
+			bChanged = true;
+		}
+	}
+	if (Refs.WeaponActor.IsValid())
+	{
+		FRPGWeaponItemStruct* Weapon = static_cast<FRPGWeaponItemStruct*>(Item);
+		UClass* ActorClass = Cast<UClass>(Refs.WeaponActor.ResolveObject());
+		if (!Weapon->WeaponActor && ActorClass && ActorClass->IsChildOf(AActor::StaticClass()))
+		{
+			Weapon->WeaponActor = ActorClass;
+			bChanged = true;
+		}
+	}
+
+	if (bChanged)
+	{
+		InvalidateBaseInfoViews(ItemId.ItemType);
+	}
+	return bChanged;
+}
+
+void FRPGItemCatalog::ReleaseLoadedAssets(ERPGItemType ItemType, const TSet<FRPGItemId>& ItemsInUse)
+{
+	const int32 FirstType = ItemType == ERPGItemType::Undefined ? 0 : (int32)ItemType;
+	const int32 LastType = ItemType == ERPGItemType::Undefined ? (int32)ERPGItemType::Undefined - 1 : (int32)ItemType;
+
+	for (int32 TypeIndex = FirstType; TypeIndex <= LastType; TypeIndex++)
+	{
+		for (int32 Index = 0; Index < SoftReferences[TypeIndex].Num(); Index++)
+		{
+			const FRPGItemId ItemId((ERPGItemType)TypeIndex, Index);
+			if (ItemsInUse.Contains(ItemId))
+			{
+				continue;
+			}
+
+			const FRPGItemSoftReferences& Refs = SoftReferences[TypeIndex][Index];
+			FRPGItemStruct* Item = GetMutableItem(ItemId);
+
+			// Only clear what came from a soft reference, inline items keep their hard references
+			if (Refs.ItemIcon.IsValid())
+			{
+				Item->ItemIcon.SetResourceObject(nullptr);
+			}
+			if (Refs.GrantedAbility.IsValid())
+			{
+				Item->GrantedAbility = nullptr;
+			}
+			if (Refs.WeaponActor.IsValid())
+			{
+				static_cast<FRPGWeaponItemStruct*>(Item)->WeaponActor = nullptr;
+			}
+		}
+		InvalidateBaseInfoViews((ERPGItemType)TypeIndex);
+	}
+}
+
+const TMap<FString, FRPGItemStruct>& FRPGItemCatalog::GetBaseInfoView(ERPGItemType ItemType) const
+{
+	const int32 ViewIndex = FMath::Min((int32)ItemType, (int32)ERPGItemType::Undefined);
+	TMap<FString, FRPGItemStruct>& View = BaseInfoViews[ViewIndex];
+
+	if (!bBaseInfoViewValid[ViewIndex])
+	{
+		const int32 FirstType = ViewIndex == (int32)ERPGItemType::Undefined ? 0 : ViewIndex;
+		const int32 LastType = ViewIndex == (int32)ERPGItemType::Undefined ? (int32)ERPGItemType::Undefined - 1 : ViewIndex;
+
+		View.Reset();
+		for (int32 TypeIndex = FirstType; TypeIndex <= LastType; TypeIndex++)
+		{
+			View.Reserve(View.Num() + Keys[TypeIndex].Num());
+			for (int32 Index = 0; Index < Keys[TypeIndex].Num(); Index++)
+			{
+				// Add overrides, so for duplicate keys the last type wins like the old GetItemsBaseInfo
+				View.Add(Keys[TypeIndex][Index].ToString(), *GetItem(FRPGItemId((ERPGItemType)TypeIndex, Index)));
+			}
+		}
+		bBaseInfoViewValid[ViewIndex] = true;
+	}
+	return View;
+}
+
+void FRPGItemCatalog::InvalidateBaseInfoViews(ERPGItemType ItemType)
+{
+	if (ItemType < ERPGItemType::Undefined)
+	{
+		bBaseInfoViewValid[(int32)ItemType] = false;
+		BaseInfoViews[(int32)ItemType].Reset();
+	}
+	bBaseInfoViewValid[(int32)ERPGItemType::Undefined] = false;
+	BaseInfoViews[(int32)ERPGItemType::Undefined].Reset();
+}
@@ -0,0 +1,197 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "RPGAttributeObserverSubsystem.h"
+#include "RPGCharacterBase.h"
+#include "Abilities/RPGAttributeSet.h"
+
+URPGAttributeObserverSubsystem* URPGAttributeObserverSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<URPGAttributeObserverSubsystem>() : nullptr;
+}
+
+void URPGAttributeObserverSubsystem::RegisterCharacter(ARPGCharacterBase* Character)
+{
+	UAbilitySystemComponent* AbilitySystem = Character ? Character->GetAbilitySystemComponent() : nullptr;
+	if (!AbilitySystem || ObservedCharacters.Contains(Character))
+	{
+		return;
+	}
+
+	FObservedCharacter& Observed = ObservedCharacters.Add(Character);
+
+	const FGameplayAttribute ObservedAttributes[] =
+	{
+		URPGAttributeSet::GetHealthAttribute(),
+		URPGAttributeSet::GetMaxHealthAttribute(),
+		URPGAttributeSet::GetManaAttribute(),
+		URPGAttributeSet::GetMaxManaAttribute(),
+		URPGAttributeSet::GetMoveSpeedAttribute(),
+	};
+
+	for (const FGameplayAttribute& Attribute : ObservedAttributes)
+	{
+		FDelegateHandle Handle = AbilitySystem->GetGameplayAttributeValueChangeDelegate(Attribute).AddUObject(this, &URPGAttributeObserverSubsystem::OnAttributeChanged, TWeakObjectPtr<ARPGCharacterBase>(Character));
+		Observed.AttributeHandles.Emplace(Attribute, Handle);
+	}
+}
+
+void URPGAttributeObserverSubsystem::UnregisterCharacter(ARPGCharacterBase* Character)
+{
+	FObservedCharacter Observed;
+	if (ObservedCharacters.RemoveAndCopyValue(Character, Observed))
+	{
+		UnbindCharacter(Character, Observed);
+	}
+}
+
+void URPGAttributeObserverSubsystem::UnbindCharacter(ARPGCharacterBase* Character, FObservedCharacter& Observed)
+{
+	UAbilitySystemComponent* AbilitySystem = Character ? Character->GetAbilitySystemComponent() : nullptr;
+	if (AbilitySystem)
+	{
+		for (const TPair<FGameplayAttribute, FDelegateHandle>& AttributeHandle : Observed.AttributeHandles)
+		{
+			AbilitySystem->GetGameplayAttributeValueChangeDelegate(AttributeHandle.Key).Remove(AttributeHandle.Value);
+		}
+	}
+	Observed.AttributeHandles.Reset();
+}
+
+void URPGAttributeObserverSubsystem::WatchCharacter(ARPGCharacterBase* Character, FOnRPGAttributesChanged OnChanged)
+{
+	if (!Character || !OnChanged.IsBound())
+	{
+		return;
+	}
+
+	RegisterCharacter(Character);
+
+	FObservedCharacter* Observed = ObservedCharacters.Find(Character);
+	if (Observed && !Observed->Watchers.Contains(OnChanged))
+	{
+		Observed->Watchers.Add(OnChanged);
+
+		// Give the new watcher a starting value so it never has to poll
+		OnChanged.Execute(MakeSnapshot(Character));
+	}
+}
+
+void URPGAttributeObserverSubsystem::UnwatchCharacter(ARPGCharacterBase* Character, FOnRPGAttributesChanged OnChanged)
+{
+	if (FObservedCharacter* Observed = ObservedCharacters.Find(Character))
+	{
+		Observed->Watchers.Remove(OnChanged);
+	}
+}
+
+FRPGAttributeSnapshot URPGAttributeObserverSubsystem::MakeSnapshot(ARPGCharacterBase* Character)
+{
+	FRPGAttributeSnapshot Snapshot;
+	if (Character)
+	{
+		Snapshot.Character = Character;
+		Snapshot.Health = Character->GetHealth();
+		Snapshot.MaxHealth = Character->GetMaxHealth();
+		Snapshot.Mana = Character->GetMana();
+		Snapshot.MaxMana = Character->GetMaxMana();
+		Snapshot.MoveSpeed = Character->GetMoveSpeed();
+	}
+	return Snapshot;
+}
+
+void URPGAttributeObserverSubsystem::OnAttributeChanged(const FOnAttributeChangeData& ChangeData, TWeakObjectPtr<ARPGCharacterBase> Character)
+{
+	FObservedCharacter* Observed = ObservedCharacters.Find(Character);
+	if (Observed && !Observed->bDirty && HasListeners(*Observed))
+	{
+		Observed->bDirty = true;
+		DirtyCharacters.Add(Character);
+	}
+}
+
+void URPGAttributeObserverSubsystem::Tick(float DeltaTime)
+{
+	// Swap out first so watchers can cause new changes, those go out next frame
+	TArray<TWeakObjectPtr<ARPGCharacterBase>> CharactersToSend = MoveTemp(DirtyCharacters);
+	DirtyCharacters.Reset();
+
+	TArray<FRPGAttributeSnapshot> Batch;
+	Batch.Reserve(CharactersToSend.Num());
+
+	for (const TWeakObjectPtr<ARPGCharacterBase>& WeakCharacter : CharactersToSend)
+	{
+		FObservedCharacter* Observed = ObservedCharacters.Find(WeakCharacter);
+		if (!Observed)
+		{
+			continue;
+		}
+		Observed->bDirty = false;
+
+		ARPGCharacterBase* Character = WeakCharacter.Get();
+		if (!Character)
+		{
+			ObservedCharacters.Remove(WeakCharacter);
+			continue;
+		}
+
+		// Watchers may have gone since the change, don't build a snapshot nobody reads
+		Observed->Watchers.RemoveAll([](const FOnRPGAttributesChanged& Watcher) { return !Watcher.IsBound(); });
+		if (!HasListeners(*Observed))
+		{
+			continue;
+		}
+
+		const FRPGAttributeSnapshot& Snapshot = Batch.Add_GetRef(MakeSnapshot(Character));
+
+		// Iterate a copy in case a watcher unwatches
+		const TArray<FOnRPGAttributesChanged> Watchers = Observed->Watchers;
+		for (const FOnRPGAttributesChanged& Watcher : Watchers)
+		{
+			Watcher.ExecuteIfBound(Snapshot);
+		}
+	}
+
+	if (Batch.Num() > 0)
+	{
+		OnAttributeBatch.Broadcast(Batch);
+	}
+}
+
+bool URPGAttributeObserverSubsystem::IsTickable() const
+{
+	return DirtyCharacters.Num() > 0 && !IsTemplate();
+}
+
+TStatId URPGAttributeObserverSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URPGAttributeObserverSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* URPGAttributeObserverSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+bool URPGAttributeObserverSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Nothing on a dedicated server displays attributes
+	UWorld* World = Outer ? Outer->GetWorld() : nullptr;
+	if (World && World->GetNetMode() == NM_DedicatedServer)
+	{
+		return false;
+	}
+	return Super::ShouldCreateSubsystem(Outer);
+}
+
+void URPGAttributeObserverSubsystem::Deinitialize()
+{
+	for (TPair<TWeakObjectPtr<ARPGCharacterBase>, FObservedCharacter>& Pair : ObservedCharacters)
+	{
+		UnbindCharacter(Pair.Key.Get(), Pair.Value);
+	}
+	ObservedCharacters.Reset();
+	DirtyCharacters.Reset();
+
+	Super::Deinitialize();
+}
@@ -63,6 +63,11 @@ FRPGGameplayEffectContainerSpec URPGBlueprintLibrary::AddTargetsToEffectContaine
 	return NewSpec;
 }
 
+void URPGBlueprintLibrary::AddTargetsToEffectContainerSpecInPlace(FRPGGameplayEffectContainerSpec& ContainerSpec, const TArray<FHitResult>& HitResults, const TArray<AActor*>& TargetActors)
+{
+	ContainerSpec.AddTargets(HitResults, TargetActors);
+}
+
 TArray<FActiveGameplayEffectHandle> URPGBlueprintLibrary::ApplyExternalEffectContainerSpec(const FRPGGameplayEffectContainerSpec& ContainerSpec)
 {
 	TArray<FActiveGameplayEffectHandle> AllEffects;
@@ -5,6 +5,8 @@
 #include "Items/RPGItem.h"
 #include "Items/RPGWeaponItem.h"
 #include "RPGGameInstanceBase.h"
+#include "RPGAttributeObserverSubsystem.h"
+#include "RPGSpatialHashSubsystem.h"
 
 #include "AbilitySystemGlobals.h"
 #include "Abilities/RPGGameplayAbility.h"
@@ -27,6 +29,7 @@ ARPGCharacterBase::ARPGCharacterBase()
 
 	CharacterLevel = 1;
 	bAbilitiesInitialized = false;
+	bBatchDamageEvents = false;
 }
 
 UAbilitySystemComponent* ARPGCharacterBase::GetAbilitySystemComponent() const
@@ -41,23 +44,10 @@ void ARPGCharacterBase::AddStartupGameplayAbilities()
 	if (GetLocalRole() == ROLE_Authority && !bAbilitiesInitialized)
 	{
 		// Grant abilities, but only on the server	
-		for (TSubclassOf<URPGGameplayAbility>& StartupAbility : GameplayAbilities)
-		{
-			AbilitySystemComponent->GiveAbility(FGameplayAbilitySpec(StartupAbility, GetCharacterLevel(), INDEX_NONE, this));
-		}
+		GetAbilityLoadout()->GiveAbilities(AbilitySystemComponent, this, GetCharacterLevel(), GrantedLoadout);
 
 		// Now apply passives
-		for (TSubclassOf<UGameplayEffect>& GameplayEffect : PassiveGameplayEffects)
-		{
-			FGameplayEffectContextHandle EffectContext = AbilitySystemComponent->MakeEffectContext();
-			EffectContext.AddSourceObject(this);
-
-			FGameplayEffectSpecHandle NewHandle = AbilitySystemComponent->MakeOutgoingSpec(GameplayEffect, GetCharacterLevel(), EffectContext);
-			if (NewHandle.IsValid())
-			{
-				FActiveGameplayEffectHandle ActiveGEHandle = AbilitySystemComponent->ApplyGameplayEffectSpecToTarget(*NewHandle.Data.Get(), AbilitySystemComponent);
-			}
-		}
+		ApplyPassiveGameplayEffects();
 
 		AddSlottedGameplayAbilities();
 
@@ -65,32 +55,118 @@ void ARPGCharacterBase::AddStartupGameplayAbilities()
 	}
 }
 
-void ARPGCharacterBase::RemoveStartupGameplayAbilities()
+TSharedRef<const FRPGAbilityLoadout> ARPGCharacterBase::GetAbilityLoadout() const
+{
+	return FRPGAbilityLoadout::Get(GetClass(), GameplayAbilities, PassiveGameplayEffects);
+}
+
+void ARPGCharacterBase::ApplyPassiveGameplayEffects()
+{
+	GetAbilityLoadout()->ApplyPassiveEffects(AbilitySystemComponent, this, GetCharacterLevel(), GrantedLoadout);
+}
+
+void ARPGCharacterBase::RelevelStartupGameplayAbilities(bool bRelevelPassiveEffects)
 {
 	check(AbilitySystemComponent);
 
-	if (GetLocalRole() == ROLE_Authority && bAbilitiesInitialized)
+	if (GetLocalRole() != ROLE_Authority || !bAbilitiesInitialized)
 	{
-		// Remove any abilities added from a previous call
-		TArray<FGameplayAbilitySpecHandle> AbilitiesToRemove;
-		for (const FGameplayAbilitySpec& Spec : AbilitySystemComponent->GetActivatableAbilities())
-		{
-			if ((Spec.SourceObject == this) && GameplayAbilities.Contains(Spec.Ability->GetClass()))
-			{
-				AbilitiesToRemove.Add(Spec.Handle);
-			}
-		}
+		return;
+	}
+
+	// Held by reference count, applying effects below may rebuild loadouts
+	const TSharedRef<const FRPGAbilityLoadout> Loadout = GetAbilityLoadout();
+	Loadout->SetAbilityLevel(AbilitySystemComponent, GetCharacterLevel(), GrantedLoadout);
+	if (bRelevelPassiveEffects)
+	{
+		Loadout->SetPassiveEffectLevel(AbilitySystemComponent, this, GetCharacterLevel(), GrantedLoadout);
+	}
 
-		// Do in two passes so the removal happens after we have the full list
-		for (int32 i = 0; i < AbilitiesToRemove.Num(); i++)
+	// Slotted abilities that use the character level, the slot keeps its ability
+	for (const TPair<FRPGItemSlot, FGameplayAbilitySpecHandle>& SlotPair : SlottedAbilities)
+	{
+		FGameplayAbilitySpec* FoundSpec = AbilitySystemComponent->FindAbilitySpecFromHandle(SlotPair.Value);
+		FGameplayAbilitySpec DesiredSpec;
+		if (FoundSpec && MakeSlottedAbilitySpec(SlotPair.Key, DesiredSpec) && DesiredSpec.Ability == FoundSpec->Ability && DesiredSpec.SourceObject == FoundSpec->SourceObject && DesiredSpec.Level != FoundSpec->Level)
 		{
-			AbilitySystemComponent->ClearAbility(AbilitiesToRemove[i]);
+			FoundSpec->Level = DesiredSpec.Level;
+			AbilitySystemComponent->MarkAbilitySpecDirty(*FoundSpec);
 		}
+	}
+}
+
+void ARPGCharacterBase::DeactivateForPool()
+{
+	check(AbilitySystemComponent);
+
+	if (GetLocalRole() == ROLE_Authority && bAbilitiesInitialized)
+	{
+		AbilitySystemComponent->CancelAllAbilities();
+
+		// An empty query matches every effect, including the passives and anything applied by other characters
+		AbilitySystemComponent->RemoveActiveEffects(FGameplayEffectQuery());
+		GrantedLoadout.ResetEffects();
+	}
+
+	// Pooled characters must not show up in targeting or health bars
+	if (URPGAttributeObserverSubsystem* AttributeObserver = URPGAttributeObserverSubsystem::Get(this))
+	{
+		AttributeObserver->UnregisterCharacter(this);
+	}
+
+	if (URPGSpatialHashSubsystem* SpatialHash = URPGSpatialHashSubsystem::Get(this))
+	{
+		SpatialHash->UnregisterCharacter(this);
+	}
+}
+
+void ARPGCharacterBase::ActivateFromPool(int32 NewLevel)
+{
+	check(AbilitySystemComponent);
+
+	CharacterLevel = NewLevel > 0 ? NewLevel : GetClass()->GetDefaultObject<ARPGCharacterBase>()->CharacterLevel;
+
+	if (!bAbilitiesInitialized)
+	{
+		// First use, pooled characters are spawned without a controller so nothing has been granted yet
+		AbilitySystemComponent->InitAbilityActorInfo(this, this);
+		AddStartupGameplayAbilities();
+	}
+	else if (GetLocalRole() == ROLE_Authority)
+	{
+		// Effects were removed on release, but instant damage changed the base values
+		AttributeSet->ResetAttributesToDefaults();
+
+		// Abilities are kept and moved to the new level, passives were removed on release and go on at the new level
+		RelevelStartupGameplayAbilities(false);
+		ApplyPassiveGameplayEffects();
+	}
+
+	if (URPGAttributeObserverSubsystem* AttributeObserver = URPGAttributeObserverSubsystem::Get(this))
+	{
+		AttributeObserver->RegisterCharacter(this);
+	}
+
+	if (URPGSpatialHashSubsystem* SpatialHash = URPGSpatialHashSubsystem::Get(this))
+	{
+		SpatialHash->RegisterCharacter(this);
+	}
+}
+
+void ARPGCharacterBase::RemoveStartupGameplayAbilities()
+{
+	check(AbilitySystemComponent);
+
+	if (GetLocalRole() == ROLE_Authority && bAbilitiesInitialized)
+	{
+		// Remove any abilities added from a previous call
+		FRPGAbilityLoadout::ClearAbilities(AbilitySystemComponent, GrantedLoadout);
 
 		// Remove all of the passive gameplay effects that were applied by this character
 		FGameplayEffectQuery Query;
 		Query.EffectSource = this;
 		AbilitySystemComponent->RemoveActiveEffects(Query);
+		GrantedLoadout.ResetEffects();
 
 		RemoveSlottedGameplayAbilities(true);
 
@@ -99,6 +175,19 @@ void ARPGCharacterBase::RemoveStartupGameplayAbilities()
 }
 
 void ARPGCharacterBase::OnItemSlotChanged(FRPGItemSlot ItemSlot, FString ItemKey, ERPGItemType ItemType)
+{
+	RefreshSlottedGameplayAbility(ItemSlot);
+}
+
+void ARPGCharacterBase::OnInventoryChangeSet(const FRPGInventoryChangeSet& ChangeSet)
+{
+	for (const FRPGSlottedItemChange& Change : ChangeSet.SlotChanges)
+	{
+		RefreshSlottedGameplayAbility(Change.ItemSlot);
+	}
+}
+
+void ARPGCharacterBase::OnItemAssetsLoaded(ERPGItemType ItemType)
 {
 	RefreshSlottedGameplayAbilities();
 }
@@ -107,55 +196,109 @@ void ARPGCharacterBase::RefreshSlottedGameplayAbilities()
 {
 	if (bAbilitiesInitialized)
 	{
-		// Refresh any invalid abilities and adds new ones
-		RemoveSlottedGameplayAbilities(false);
-		AddSlottedGameplayAbilities();
+		// Refresh any invalid abilities and adds new ones, in one pass over every slot that has or could have an ability
+		TSet<FRPGItemSlot> Slots;
+		SlottedAbilities.GetKeys(Slots);
+		for (const TPair<FRPGItemSlot, TSubclassOf<URPGGameplayAbility>>& DefaultPair : DefaultSlottedAbilities)
+		{
+			Slots.Add(DefaultPair.Key);
+		}
+		if (InventorySource)
+		{
+			for (const TPair<FRPGItemSlot, FString>& ItemPair : InventorySource->GetSlottedItemMap())
+			{
+				Slots.Add(ItemPair.Key);
+			}
+		}
+
+		for (const FRPGItemSlot& ItemSlot : Slots)
+		{
+			RefreshSlottedGameplayAbility(ItemSlot);
+		}
+	}
+}
+
+void ARPGCharacterBase::RefreshSlottedGameplayAbility(const FRPGItemSlot& ItemSlot)
+{
+	if (!bAbilitiesInitialized || !AbilitySystemComponent)
+	{
+		return;
+	}
+
+	FGameplayAbilitySpec DesiredSpec;
+	const bool bHasDesiredSpec = MakeSlottedAbilitySpec(ItemSlot, DesiredSpec);
+
+	FGameplayAbilitySpecHandle* ExistingHandle = SlottedAbilities.Find(ItemSlot);
+	FGameplayAbilitySpec* FoundSpec = ExistingHandle ? AbilitySystemComponent->FindAbilitySpecFromHandle(*ExistingHandle) : nullptr;
+
+	if (FoundSpec && bHasDesiredSpec && DesiredSpec.Ability == FoundSpec->Ability && DesiredSpec.SourceObject == FoundSpec->SourceObject)
+	{
+		// Slot already grants the right ability
+		return;
+	}
+
+	if (FoundSpec)
+	{
+		AbilitySystemComponent->ClearAbility(*ExistingHandle);
+	}
+
+	if (bHasDesiredSpec)
+	{
+		SlottedAbilities.FindOrAdd(ItemSlot) = AbilitySystemComponent->GiveAbility(DesiredSpec);
+	}
+	else if (ExistingHandle)
+	{
+		*ExistingHandle = FGameplayAbilitySpecHandle();
 	}
 }
 
+bool ARPGCharacterBase::MakeSlottedAbilitySpec(const FRPGItemSlot& ItemSlot, FGameplayAbilitySpec& OutSpec)
+{
+	// Inventory overrides the default ability for the slot
+	const FString* ItemKey = InventorySource ? InventorySource->GetSlottedItemMap().Find(ItemSlot) : nullptr;
+
+	// Empty slots keep the default ability
+	const FRPGItemStruct* itemData = (ItemKey && !ItemKey->IsEmpty() && GetGameInstance()) ? GetGameInstance()->FindBaseItem(*ItemKey, ItemSlot.ItemType) : nullptr;
+	if (itemData && itemData->GrantedAbility)
+	{
+		// Use the character level as default, weapons use the data from the slotted item
+		const int32 AbilityLevel = itemData->ItemType == ERPGItemType::Weapon ? itemData->AbilityLevel : GetCharacterLevel();
+
+		// This needs to be reviewed to ensure that the ability owner beign set to game instance is acceptable
+		// May be instances of code trying to cast old data types from object owner :(
+		OutSpec = FGameplayAbilitySpec(itemData->GrantedAbility, AbilityLevel, INDEX_NONE, GetGameInstance());
+		return true;
+	}
+
+	const TSubclassOf<URPGGameplayAbility>* DefaultAbility = DefaultSlottedAbilities.Find(ItemSlot);
+	if (DefaultAbility && DefaultAbility->Get())
+	{
+		OutSpec = FGameplayAbilitySpec(*DefaultAbility, GetCharacterLevel(), INDEX_NONE, this);
+		return true;
+	}
+
+	return false;
+}
+
 void ARPGCharacterBase::FillSlottedAbilitySpecs(TMap<FRPGItemSlot, FGameplayAbilitySpec>& SlottedAbilitySpecs)
 {
-	// First add default ones
-	for (const TPair<FRPGItemSlot, TSubclassOf<URPGGameplayAbility>>& DefaultPair : DefaultSlottedAbilities)
+	// Every slot that has a default or is known to the inventory, each resolved the same way as a single slot refresh
+	TSet<FRPGItemSlot> Slots;
+	DefaultSlottedAbilities.GetKeys(Slots);
+	if (InventorySource)
 	{
-		if (DefaultPair.Value.Get())
+		for (const TPair<FRPGItemSlot, FString>& ItemPair : InventorySource->GetSlottedItemMap())
 		{
-			SlottedAbilitySpecs.Add(DefaultPair.Key, FGameplayAbilitySpec(DefaultPair.Value, GetCharacterLevel(), INDEX_NONE, this));
+			Slots.Add(ItemPair.Key);
 		}
 	}
 
-	// Now potentially override with inventory
-	if (InventorySource)
+	for (const FRPGItemSlot& ItemSlot : Slots)
 	{
-		const TMap<FRPGItemSlot, FString>& SlottedItemMap = InventorySource->GetSlottedItemMap();
-
-		for (const TPair<FRPGItemSlot, FString>& ItemPair : SlottedItemMap)
+		FGameplayAbilitySpec Spec;
+		if (MakeSlottedAbilitySpec(ItemSlot, Spec))
 		{
-			FString itemKey = ItemPair.Value;
-			FRPGItemSlot itemSlot = ItemPair.Key;
-
-			// Use the character level as default
-			int32 AbilityLevel = GetCharacterLevel();
-
-			FRPGItemStruct itemData;
-			if (GetGameInstance() && GetGameInstance()->TryGetBaseItemData(itemKey, itemSlot.ItemType, itemData))
-			{
-				if (itemData.ItemType == ERPGItemType::Weapon)
-				{
-					FRPGWeaponItemStruct weapon;
-
-					// Override the ability level to use the data from the slotted item
-					AbilityLevel = itemData.AbilityLevel;
-				}
-
-				if (itemData.GrantedAbility)
-				{
-					// This will override anything from default
-					// This needs to be reviewed to ensure that the ability owner beign set to game instance is acceptable
-					// May be instances of code trying to cast old data types from object owner :(
-					SlottedAbilitySpecs.Add(ItemPair.Key, FGameplayAbilitySpec(itemData.GrantedAbility, AbilityLevel, INDEX_NONE, GetGameInstance()));
-				}
-			}			
+			SlottedAbilitySpecs.Add(ItemSlot, Spec);
 		}
 	}
 }
@@ -217,6 +360,37 @@ void ARPGCharacterBase::RemoveSlottedGameplayAbilities(bool bRemoveAll)
 	}
 }
 
+void ARPGCharacterBase::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Push attribute changes to widgets instead of having them poll
+	if (URPGAttributeObserverSubsystem* AttributeObserver = URPGAttributeObserverSubsystem::Get(this))
+	{
+		AttributeObserver->RegisterCharacter(this);
+	}
+
+	if (URPGSpatialHashSubsystem* SpatialHash = URPGSpatialHashSubsystem::Get(this))
+	{
+		SpatialHash->RegisterCharacter(this);
+	}
+}
+
+void ARPGCharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (URPGAttributeObserverSubsystem* AttributeObserver = URPGAttributeObserverSubsystem::Get(this))
+	{
+		AttributeObserver->UnregisterCharacter(this);
+	}
+
+	if (URPGSpatialHashSubsystem* SpatialHash = URPGSpatialHashSubsystem::Get(this))
+	{
+		SpatialHash->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ARPGCharacterBase::PossessedBy(AController* NewController)
 {
 	Super::PossessedBy(NewController);
@@ -228,6 +402,12 @@ void ARPGCharacterBase::PossessedBy(AController* NewController)
 	{
 		InventoryUpdateHandle = InventorySource->GetSlottedItemChangedDelegate().AddUObject(this, &ARPGCharacterBase::OnItemSlotChanged);
 		InventoryLoadedHandle = InventorySource->GetInventoryLoadedDelegate().AddUObject(this, &ARPGCharacterBase::RefreshSlottedGameplayAbilities);
+		InventoryChangeSetHandle = InventorySource->GetInventoryChangeSetDelegate().AddUObject(this, &ARPGCharacterBase::OnInventoryChangeSet);
+
+		if (GetGameInstance() && !ItemAssetsLoadedHandle.IsValid())
+		{
+			ItemAssetsLoadedHandle = GetGameInstance()->OnItemAssetsLoadedNative.AddUObject(this, &ARPGCharacterBase::OnItemAssetsLoaded);
+		}
 	}
 
 	// Initialize our abilities
@@ -248,6 +428,18 @@ void ARPGCharacterBase::UnPossessed()
 
 		InventorySource->GetInventoryLoadedDelegate().Remove(InventoryLoadedHandle);
 		InventoryLoadedHandle.Reset();
+
+		InventorySource->GetInventoryChangeSetDelegate().Remove(InventoryChangeSetHandle);
+		InventoryChangeSetHandle.Reset();
+	}
+
+	if (ItemAssetsLoadedHandle.IsValid())
+	{
+		if (GetGameInstance())
+		{
+			GetGameInstance()->OnItemAssetsLoadedNative.Remove(ItemAssetsLoadedHandle);
+		}
+		ItemAssetsLoadedHandle.Reset();
 	}
 
 	InventorySource = nullptr;
@@ -305,10 +497,17 @@ bool ARPGCharacterBase::SetCharacterLevel(int32 NewLevel)
 {
 	if (CharacterLevel != NewLevel && NewLevel > 0)
 	{
-		// Our level changed so we need to refresh abilities
-		RemoveStartupGameplayAbilities();
 		CharacterLevel = NewLevel;
-		AddStartupGameplayAbilities();
+
+		// Our level changed so we need to refresh abilities, in place if they are already granted
+		if (bAbilitiesInitialized)
+		{
+			RelevelStartupGameplayAbilities();
+		}
+		else
+		{
+			AddStartupGameplayAbilities();
+		}
 
 		return true;
 	}
@@ -337,27 +536,51 @@ void ARPGCharacterBase::GetActiveAbilitiesWithItemSlot(FRPGItemSlot ItemSlot, TA
 
 		if (FoundSpec)
 		{
-			TArray<UGameplayAbility*> AbilityInstances = FoundSpec->GetAbilityInstances();
-
 			// Find all ability instances executed from this slot
-			for (UGameplayAbility* ActiveAbility : AbilityInstances)
+			URPGAbilitySystemComponent::ForEachAbilityInstance(*FoundSpec, [&ActiveAbilities](URPGGameplayAbility* ActiveAbility)
 			{
-				ActiveAbilities.Add(Cast<URPGGameplayAbility>(ActiveAbility));
-			}
+				ActiveAbilities.Add(ActiveAbility);
+				return true;
+			});
 		}
 	}
 }
 
+bool ARPGCharacterBase::IsAbilityActiveWithItemSlot(FRPGItemSlot ItemSlot) const
+{
+	const FGameplayAbilitySpecHandle* FoundHandle = SlottedAbilities.Find(ItemSlot);
+
+	if (FoundHandle && AbilitySystemComponent)
+	{
+		const FGameplayAbilitySpec* FoundSpec = AbilitySystemComponent->FindAbilitySpecFromHandle(*FoundHandle);
+		return FoundSpec && FoundSpec->IsActive();
+	}
+	return false;
+}
+
 bool ARPGCharacterBase::ActivateAbilitiesWithTags(FGameplayTagContainer AbilityTags, bool bAllowRemoteActivation)
 {
 	if (AbilitySystemComponent)
 	{
-		return AbilitySystemComponent->TryActivateAbilitiesByTag(AbilityTags, bAllowRemoteActivation);
+		return AbilitySystemComponent->TryActivateAbilitiesByTagIndexed(AbilityTags, bAllowRemoteActivation);
 	}
 
 	return false;
 }
 
+int32 ARPGCharacterBase::ActivateAbilitiesWithTagsOnCharacters(const TArray<ARPGCharacterBase*>& Characters, FGameplayTagContainer AbilityTags, bool bAllowRemoteActivation)
+{
+	int32 NumActivated = 0;
+	for (ARPGCharacterBase* Character : Characters)
+	{
+		if (Character && Character->AbilitySystemComponent && Character->AbilitySystemComponent->TryActivateAbilitiesByTagIndexed(AbilityTags, bAllowRemoteActivation))
+		{
+			NumActivated++;
+		}
+	}
+	return NumActivated;
+}
+
 void ARPGCharacterBase::GetActiveAbilitiesWithTags(FGameplayTagContainer AbilityTags, TArray<URPGGameplayAbility*>& ActiveAbilities)
 {
 	if (AbilitySystemComponent)
@@ -366,35 +589,45 @@ void ARPGCharacterBase::GetActiveAbilitiesWithTags(FGameplayTagContainer Ability
 	}
 }
 
+bool ARPGCharacterBase::IsAnyAbilityActiveWithTags(FGameplayTagContainer AbilityTags) const
+{
+	return AbilitySystemComponent && AbilitySystemComponent->IsAnyAbilityActiveWithTags(AbilityTags);
+}
+
 bool ARPGCharacterBase::GetCooldownRemainingForTag(FGameplayTagContainer CooldownTags, float& TimeRemaining, float& CooldownDuration)
 {
 	if (AbilitySystemComponent && CooldownTags.Num() > 0)
 	{
-		TimeRemaining = 0.f;
-		CooldownDuration = 0.f;
+		return AbilitySystemComponent->GetCooldownRemainingForTags(CooldownTags, TimeRemaining, CooldownDuration);
+	}
+	return false;
+}
+
+void ARPGCharacterBase::GetSlottedAbilityCooldowns(TArray<FRPGSlottedAbilityCooldown>& OutCooldowns)
+{
+	OutCooldowns.Reset(SlottedAbilities.Num());
+	if (!AbilitySystemComponent)
+	{
+		return;
+	}
 
-		FGameplayEffectQuery const Query = FGameplayEffectQuery::MakeQuery_MatchAnyOwningTags(CooldownTags);
-		TArray< TPair<float, float> > DurationAndTimeRemaining = AbilitySystemComponent->GetActiveEffectsTimeRemainingAndDuration(Query);
-		if (DurationAndTimeRemaining.Num() > 0)
+	for (const TPair<FRPGItemSlot, FGameplayAbilitySpecHandle>& SlotPair : SlottedAbilities)
+	{
+		FGameplayAbilitySpec* FoundSpec = AbilitySystemComponent->FindAbilitySpecFromHandle(SlotPair.Value);
+		if (!FoundSpec || !FoundSpec->Ability)
 		{
-			int32 BestIdx = 0;
-			float LongestTime = DurationAndTimeRemaining[0].Key;
-			for (int32 Idx = 1; Idx < DurationAndTimeRemaining.Num(); ++Idx)
-			{
-				if (DurationAndTimeRemaining[Idx].Key > LongestTime)
-				{
-					LongestTime = DurationAndTimeRemaining[Idx].Key;
-					BestIdx = Idx;
-				}
-			}
+			continue;
+		}
 
-			TimeRemaining = DurationAndTimeRemaining[BestIdx].Key;
-			CooldownDuration = DurationAndTimeRemaining[BestIdx].Value;
+		FRPGSlottedAbilityCooldown& Cooldown = OutCooldowns.AddDefaulted_GetRef();
+		Cooldown.ItemSlot = SlotPair.Key;
 
-			return true;
+		const FGameplayTagContainer* CooldownTags = FoundSpec->Ability->GetCooldownTags();
+		if (CooldownTags && CooldownTags->Num() > 0)
+		{
+			Cooldown.bOnCooldown = AbilitySystemComponent->GetCooldownRemainingForTags(*CooldownTags, Cooldown.TimeRemaining, Cooldown.CooldownDuration);
 		}
 	}
-	return false;
 }
 
 void ARPGCharacterBase::HandleDamage(float DamageAmount, const FHitResult& HitInfo, const struct FGameplayTagContainer& DamageTags, ARPGCharacterBase* InstigatorPawn, AActor* DamageCauser)
@@ -402,6 +635,22 @@ void ARPGCharacterBase::HandleDamage(float DamageAmount, const FHitResult& HitIn
 	OnDamaged(DamageAmount, HitInfo, DamageTags, InstigatorPawn, DamageCauser);	
 }
 
+void ARPGCharacterBase::HandleDamageEvents(const TArray<FRPGDamageEvent>& DamageEvents)
+{
+	float TotalDamage = 0.f;
+	FGameplayTagContainer EventTags;
+	for (const FRPGDamageEvent& DamageEvent : DamageEvents)
+	{
+		TotalDamage += DamageEvent.DamageAmount;
+		EventTags.AppendTags(DamageEvent.DamageTags);
+	}
+
+	OnDamagedBatch(DamageEvents, TotalDamage);
+
+	// Call once for all health changes of the frame
+	HandleHealthChanged(-TotalDamage, EventTags);
+}
+
 void ARPGCharacterBase::HandleHealthChanged(float DeltaValue, const struct FGameplayTagContainer& EventTags)
 {
 	// We only call the BP callback if this is not the initial ability setup
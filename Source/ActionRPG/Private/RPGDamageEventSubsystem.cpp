@@ -0,0 +1,69 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "RPGDamageEventSubsystem.h"
+#include "RPGCharacterBase.h"
+
+URPGDamageEventSubsystem* URPGDamageEventSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<URPGDamageEventSubsystem>() : nullptr;
+}
+
+void URPGDamageEventSubsystem::QueueDamageEvent(FRPGDamageEvent&& DamageEvent)
+{
+	PendingEvents.Add(MoveTemp(DamageEvent));
+}
+
+void URPGDamageEventSubsystem::DispatchDamageEvents()
+{
+	// Swap out first, handlers can cause more damage which goes out next frame
+	TArray<FRPGDamageEvent> Events = MoveTemp(PendingEvents);
+	PendingEvents.Reset();
+
+	if (Events.Num() == 0)
+	{
+		return;
+	}
+
+	// Notify native before blueprint
+	OnDamageEventsNative.Broadcast(Events);
+	OnDamageEvents.Broadcast(Events);
+
+	// Group by target, keeping the order of hits on each target
+	TMap<ARPGCharacterBase*, TArray<FRPGDamageEvent>> EventsByTarget;
+	for (FRPGDamageEvent& DamageEvent : Events)
+	{
+		if (DamageEvent.TargetCharacter)
+		{
+			EventsByTarget.FindOrAdd(DamageEvent.TargetCharacter).Add(MoveTemp(DamageEvent));
+		}
+	}
+
+	for (const TPair<ARPGCharacterBase*, TArray<FRPGDamageEvent>>& TargetEvents : EventsByTarget)
+	{
+		if (!TargetEvents.Key->IsPendingKill())
+		{
+			TargetEvents.Key->HandleDamageEvents(TargetEvents.Value);
+		}
+	}
+}
+
+void URPGDamageEventSubsystem::Tick(float DeltaTime)
+{
+	DispatchDamageEvents();
+}
+
+bool URPGDamageEventSubsystem::IsTickable() const
+{
+	return PendingEvents.Num() > 0 && !IsTemplate();
+}
+
+TStatId URPGDamageEventSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URPGDamageEventSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* URPGDamageEventSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
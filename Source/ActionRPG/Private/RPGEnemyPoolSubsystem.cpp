@@ -0,0 +1,181 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "RPGEnemyPoolSubsystem.h"
+#include "RPGCharacterBase.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Engine/World.h"
+
+namespace RPGEnemyPool
+{
+	/** Shows or hides a pooled enemy, component ticks go back to what the class starts with */
+	static void SetEnemyActive(ARPGCharacterBase* Enemy, bool bActive)
+	{
+		Enemy->SetActorHiddenInGame(!bActive);
+		Enemy->SetActorEnableCollision(bActive);
+		Enemy->SetActorTickEnabled(bActive && Enemy->PrimaryActorTick.bStartWithTickEnabled);
+
+		for (UActorComponent* Component : Enemy->GetComponents())
+		{
+			if (Component)
+			{
+				Component->SetComponentTickEnabled(bActive && Component->PrimaryComponentTick.bStartWithTickEnabled);
+			}
+		}
+	}
+}
+
+URPGEnemyPoolSubsystem* URPGEnemyPoolSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<URPGEnemyPoolSubsystem>() : nullptr;
+}
+
+ARPGCharacterBase* URPGEnemyPoolSubsystem::SpawnEnemy(UClass* CharacterClass, const FTransform& SpawnTransform)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	// Possession waits for AcquireEnemy, so prewarmed enemies never start their AI
+	ARPGCharacterBase* Enemy = World->SpawnActorDeferred<ARPGCharacterBase>(CharacterClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+	if (Enemy)
+	{
+		Enemy->AutoPossessAI = EAutoPossessAI::Disabled;
+		Enemy->FinishSpawning(SpawnTransform);
+	}
+	return Enemy;
+}
+
+ARPGCharacterBase* URPGEnemyPoolSubsystem::AcquireEnemy(TSubclassOf<ARPGCharacterBase> CharacterClass, const FTransform& SpawnTransform, int32 CharacterLevel)
+{
+	if (!CharacterClass)
+	{
+		return nullptr;
+	}
+
+	ARPGCharacterBase* Enemy = nullptr;
+	FRPGPooledActorList* FreeList = FreeEnemies.Find(CharacterClass);
+	while (!Enemy && FreeList && FreeList->Actors.Num() > 0)
+	{
+		Enemy = Cast<ARPGCharacterBase>(FreeList->Actors.Pop(false));
+
+		// Pooled actors can still be destroyed by a level unload
+		if (Enemy && Enemy->IsPendingKill())
+		{
+			Enemy = nullptr;
+		}
+	}
+
+	if (Enemy)
+	{
+		Enemy->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+		RPGEnemyPool::SetEnemyActive(Enemy, true);
+	}
+	else
+	{
+		Enemy = SpawnEnemy(CharacterClass, SpawnTransform);
+		if (!Enemy)
+		{
+			return nullptr;
+		}
+	}
+
+	// Reset abilities before possession, so the controller sees a live character
+	Enemy->ActivateFromPool(CharacterLevel);
+
+	if (UCharacterMovementComponent* Movement = Enemy->GetCharacterMovement())
+	{
+		Movement->SetDefaultMovementMode();
+	}
+
+	if (!Enemy->GetController())
+	{
+		Enemy->SpawnDefaultController();
+	}
+
+	if (Enemy->GetClass()->ImplementsInterface(URPGPoolableInterface::StaticClass()))
+	{
+		IRPGPoolableInterface::Execute_OnAcquiredFromPool(Enemy);
+	}
+	return Enemy;
+}
+
+void URPGEnemyPoolSubsystem::ReleaseEnemy(ARPGCharacterBase* Enemy)
+{
+	if (!Enemy || Enemy->IsPendingKill())
+	{
+		return;
+	}
+
+	if (Enemy->GetClass()->ImplementsInterface(URPGPoolableInterface::StaticClass()))
+	{
+		IRPGPoolableInterface::Execute_OnReturnedToPool(Enemy);
+	}
+
+	// Death logic often sets a life span, the pool owns the character now
+	Enemy->SetLifeSpan(0.f);
+
+	// AI controllers are destroyed, a new one is spawned on acquire so behavior starts from scratch
+	Enemy->DetachFromControllerPendingDestroy();
+	Enemy->DeactivateForPool();
+
+	if (UCharacterMovementComponent* Movement = Enemy->GetCharacterMovement())
+	{
+		Movement->StopMovementImmediately();
+	}
+
+	RPGEnemyPool::SetEnemyActive(Enemy, false);
+
+	FreeEnemies.FindOrAdd(Enemy->GetClass()).Actors.AddUnique(Enemy);
+}
+
+void URPGEnemyPoolSubsystem::PrewarmEnemies(TSubclassOf<ARPGCharacterBase> CharacterClass, int32 Count)
+{
+	if (!CharacterClass)
+	{
+		return;
+	}
+
+	const int32 NumFree = FreeEnemies.FindOrAdd(CharacterClass).Actors.Num();
+	for (int32 Index = NumFree; Index < Count; Index++)
+	{
+		if (ARPGCharacterBase* Enemy = SpawnEnemy(CharacterClass, FTransform::Identity))
+		{
+			// Grant abilities now, so the first acquire takes the cheap reset path
+			Enemy->ActivateFromPool(0);
+			ReleaseEnemy(Enemy);
+		}
+	}
+}
+
+void URPGEnemyPoolSubsystem::PrewarmForWave(const TArray<FRPGEnemySpawnCount>& SpawnCounts)
+{
+	TMap<UClass*, int32> CountsByClass;
+	for (const FRPGEnemySpawnCount& SpawnCount : SpawnCounts)
+	{
+		if (SpawnCount.CharacterClass && SpawnCount.Count > 0)
+		{
+			CountsByClass.FindOrAdd(SpawnCount.CharacterClass) += SpawnCount.Count;
+		}
+	}
+
+	for (const TPair<UClass*, int32>& ClassCount : CountsByClass)
+	{
+		PrewarmEnemies(ClassCount.Key, ClassCount.Value);
+	}
+}
+
+int32 URPGEnemyPoolSubsystem::GetNumFreeEnemies(TSubclassOf<ARPGCharacterBase> CharacterClass) const
+{
+	const FRPGPooledActorList* FreeList = FreeEnemies.Find(CharacterClass);
+	return FreeList ? FreeList->Actors.Num() : 0;
+}
+
+void URPGEnemyPoolSubsystem::Deinitialize()
+{
+	FreeEnemies.Reset();
+
+	Super::Deinitialize();
+}
@@ -2,7 +2,11 @@
 
 #include "RPGGameInstanceBase.h"
 #include "Items/RPGItem.h"
+#include "RPGInventoryInterface.h"
 #include "Kismet/GameplayStatics.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "Engine/DataTable.h"
 
 // LA -
 // Prevents code optimisation which is useful for stepping through as it means
@@ -12,27 +16,56 @@
 #pragma optimize("", off)
 
 URPGGameInstanceBase::URPGGameInstanceBase()
+	: ItemPreloadBatchSize(16)
+	, SaveSlot(TEXT("SaveGame"))
+	, SaveUserIndex(0)
+	, ItemCatalogGeneration(0)
 {}
 
-bool URPGGameInstanceBase::ItemExists(FString ItemKey, ERPGItemType ItemType) const
+bool URPGGameInstanceBase::ItemExists(const FString& ItemKey, ERPGItemType ItemType) const
 {
-	switch (ItemType)
+	return ItemCatalog.FindItemId(FRPGItemCatalog::MakeKeyName(ItemKey), ItemType).IsValid();
+}
+
+const FRPGItemStruct* URPGGameInstanceBase::FindBaseItem(const FString& ItemKey, ERPGItemType ItemType, FRPGItemId* OutItemId) const
+{
+	const FName KeyName = FRPGItemCatalog::MakeKeyName(ItemKey);
+	const FRPGItemId ItemId = ItemType == ERPGItemType::Undefined ? ItemCatalog.FindAnyItemId(KeyName) : ItemCatalog.FindItemId(KeyName, ItemType);
+	if (OutItemId)
 	{
-	case ERPGItemType::Potion:
-		return Potions.Contains(ItemKey);
-	case ERPGItemType::Skill:
-		return Skills.Contains(ItemKey);
-	case ERPGItemType::Token:
-		return Tokens.Contains(ItemKey);
-	case ERPGItemType::Weapon:
-		return Weapons.Contains(ItemKey);
+		*OutItemId = ItemId;
 	}
-	return false;
+	return ItemCatalog.GetItem(ItemId);
+}
+
+const FRPGItemStruct* URPGGameInstanceBase::FindBaseItem(const FRPGItemId& ItemId) const
+{
+	return ItemCatalog.GetItem(ItemId);
+}
+
+const FRPGPotionItemStruct* URPGGameInstanceBase::FindPotion(const FString& PotionKey) const
+{
+	return ItemCatalog.GetPotion(ItemCatalog.FindItemId(FRPGItemCatalog::MakeKeyName(PotionKey), ERPGItemType::Potion).Index);
+}
+
+const FRPGSkillItemStruct* URPGGameInstanceBase::FindSkill(const FString& SkillKey) const
+{
+	return ItemCatalog.GetSkill(ItemCatalog.FindItemId(FRPGItemCatalog::MakeKeyName(SkillKey), ERPGItemType::Skill).Index);
+}
+
+const FRPGTokenItemStruct* URPGGameInstanceBase::FindToken(const FString& TokenKey) const
+{
+	return ItemCatalog.GetToken(ItemCatalog.FindItemId(FRPGItemCatalog::MakeKeyName(TokenKey), ERPGItemType::Token).Index);
+}
+
+const FRPGWeaponItemStruct* URPGGameInstanceBase::FindWeapon(const FString& WeaponKey) const
+{
+	return ItemCatalog.GetWeapon(ItemCatalog.FindItemId(FRPGItemCatalog::MakeKeyName(WeaponKey), ERPGItemType::Weapon).Index);
 }
 
-bool URPGGameInstanceBase::TryGetPotion(FString PotionKey, FRPGPotionItemStruct& outPotion) const
+bool URPGGameInstanceBase::TryGetPotion(const FString& PotionKey, FRPGPotionItemStruct& outPotion) const
 {
-	const FRPGPotionItemStruct* ptr = Potions.Find(PotionKey);
+	const FRPGPotionItemStruct* ptr = FindPotion(PotionKey);
 	if (ptr != nullptr)
 	{
 		outPotion = *ptr;
@@ -42,9 +75,9 @@ bool URPGGameInstanceBase::TryGetPotion(FString PotionKey, FRPGPotionItemStruct&
 	return false;
 }
 
-FRPGPotionItemStruct URPGGameInstanceBase::GetPotion(FString PotionKey) const
+FRPGPotionItemStruct URPGGameInstanceBase::GetPotion(const FString& PotionKey) const
 {
-	const FRPGPotionItemStruct* ptr = Potions.Find(PotionKey);
+	const FRPGPotionItemStruct* ptr = FindPotion(PotionKey);
 	if (ptr != nullptr)
 	{
 		return *ptr;
@@ -52,9 +85,9 @@ FRPGPotionItemStruct URPGGameInstanceBase::GetPotion(FString PotionKey) const
 	return FRPGPotionItemStruct();
 }
 
-bool URPGGameInstanceBase::TryGetSkill(FString SkillKey, FRPGSkillItemStruct& outSkill) const
+bool URPGGameInstanceBase::TryGetSkill(const FString& SkillKey, FRPGSkillItemStruct& outSkill) const
 {
-	const FRPGSkillItemStruct* ptr = Skills.Find(SkillKey);
+	const FRPGSkillItemStruct* ptr = FindSkill(SkillKey);
 	if (ptr != nullptr)
 	{
 		outSkill = *ptr;
@@ -64,9 +97,9 @@ bool URPGGameInstanceBase::TryGetSkill(FString SkillKey, FRPGSkillItemStruct& ou
 	return false;
 }
 
-FRPGSkillItemStruct URPGGameInstanceBase::GetSkill(FString SkillKey) const
+FRPGSkillItemStruct URPGGameInstanceBase::GetSkill(const FString& SkillKey) const
 {
-	const FRPGSkillItemStruct* ptr = Skills.Find(SkillKey);
+	const FRPGSkillItemStruct* ptr = FindSkill(SkillKey);
 	if (ptr != nullptr)
 	{
 		return *ptr;
@@ -74,9 +107,9 @@ FRPGSkillItemStruct URPGGameInstanceBase::GetSkill(FString SkillKey) const
 	return FRPGSkillItemStruct();
 }
 
-bool URPGGameInstanceBase::TryGetToken(FString TokenKey, FRPGTokenItemStruct& outToken) const
+bool URPGGameInstanceBase::TryGetToken(const FString& TokenKey, FRPGTokenItemStruct& outToken) const
 {
-	const FRPGTokenItemStruct* ptr = Tokens.Find(TokenKey);
+	const FRPGTokenItemStruct* ptr = FindToken(TokenKey);
 	if (ptr != nullptr)
 	{
 		outToken = *ptr;
@@ -86,9 +119,9 @@ bool URPGGameInstanceBase::TryGetToken(FString TokenKey, FRPGTokenItemStruct& ou
 	return false;
 }
 
-FRPGTokenItemStruct URPGGameInstanceBase::GetToken(FString TokenKey) const
+FRPGTokenItemStruct URPGGameInstanceBase::GetToken(const FString& TokenKey) const
 {
-	const FRPGTokenItemStruct* ptr = Tokens.Find(TokenKey);
+	const FRPGTokenItemStruct* ptr = FindToken(TokenKey);
 	if (ptr != nullptr)
 	{
 		return *ptr;
@@ -96,9 +129,9 @@ FRPGTokenItemStruct URPGGameInstanceBase::GetToken(FString TokenKey) const
 	return FRPGTokenItemStruct();
 }
 
-bool URPGGameInstanceBase::TryGetWeapon(FString WeaponKey, FRPGWeaponItemStruct& outWeapon) const
+bool URPGGameInstanceBase::TryGetWeapon(const FString& WeaponKey, FRPGWeaponItemStruct& outWeapon) const
 {
-	const FRPGWeaponItemStruct* ptr = Weapons.Find(WeaponKey);
+	const FRPGWeaponItemStruct* ptr = FindWeapon(WeaponKey);
 	if (ptr != nullptr)
 	{
 		outWeapon = *ptr;
@@ -108,9 +141,9 @@ bool URPGGameInstanceBase::TryGetWeapon(FString WeaponKey, FRPGWeaponItemStruct&
 	return false;
 }
 
-FRPGWeaponItemStruct URPGGameInstanceBase::GetWeapon(FString WeaponKey) const
+FRPGWeaponItemStruct URPGGameInstanceBase::GetWeapon(const FString& WeaponKey) const
 {
-	const FRPGWeaponItemStruct* ptr = Weapons.Find(WeaponKey);
+	const FRPGWeaponItemStruct* ptr = FindWeapon(WeaponKey);
 	if (ptr != nullptr)
 	{
 		return *ptr;
@@ -118,175 +151,279 @@ FRPGWeaponItemStruct URPGGameInstanceBase::GetWeapon(FString WeaponKey) const
 	return FRPGWeaponItemStruct();
 }
 
-bool URPGGameInstanceBase::TryGetBaseItemData(FString ItemKey, ERPGItemType ItemType, FRPGItemStruct& outItem) const
+bool URPGGameInstanceBase::TryGetBaseItemData(const FString& ItemKey, ERPGItemType ItemType, FRPGItemStruct& outItem) const
 {
-	switch (ItemType)
-	{
-	case ERPGItemType::Potion:
-	{
-		FRPGItemStruct* ptr = (FRPGItemStruct*)Potions.Find(ItemKey);
-		if (ptr != nullptr) outItem = *ptr;
-		return ptr != nullptr;
-	}		
-	case ERPGItemType::Skill:
-	{
-		FRPGItemStruct* ptr = (FRPGItemStruct*)Skills.Find(ItemKey);
-		if (ptr != nullptr) outItem = *ptr;
-		return ptr != nullptr;
-	}
-	case ERPGItemType::Token:
-	{
-		FRPGItemStruct* ptr = (FRPGItemStruct*)Tokens.Find(ItemKey);
-		if (ptr != nullptr) outItem = *ptr;
-		return ptr != nullptr;
-	}
-	case ERPGItemType::Weapon:
+	const FRPGItemStruct* ptr = FindBaseItem(ItemKey, ItemType);
+	if (ptr != nullptr)
 	{
-		FRPGItemStruct* ptr = (FRPGItemStruct*)Weapons.Find(ItemKey);
-		if (ptr != nullptr) outItem = *ptr;
-		return ptr != nullptr;
-	}
-	case ERPGItemType::Undefined:
-		ERPGItemType itemType;
-		bool found = FindItem(ItemKey, itemType, outItem);
-		return found;
+		outItem = *ptr;
+		return true;
 	}
 	outItem = FRPGItemStruct();
 	return false;
 }
 
-FRPGItemStruct URPGGameInstanceBase::GetBaseItemData(FString ItemKey, ERPGItemType ItemType) const
+FRPGItemStruct URPGGameInstanceBase::GetBaseItemData(const FString& ItemKey, ERPGItemType ItemType) const
 {
-	switch (ItemType)
-	{
-	case ERPGItemType::Potion:
-	{
-		FRPGItemStruct* ptr = (FRPGItemStruct*)Potions.Find(ItemKey);
-		if (ptr != nullptr) return *ptr;
-		else return FRPGItemStruct();
-	}
-	case ERPGItemType::Skill:
-	{
-		FRPGItemStruct* ptr = (FRPGItemStruct*)Skills.Find(ItemKey);
-		if (ptr != nullptr) return *ptr;
-		else return FRPGItemStruct();
-	}
-	case ERPGItemType::Token:
-	{
-		FRPGItemStruct* ptr = (FRPGItemStruct*)Tokens.Find(ItemKey);
-		if (ptr != nullptr) return *ptr;
-		else return FRPGItemStruct();
-	}
-	case ERPGItemType::Weapon:
-	{
-		FRPGItemStruct* ptr = (FRPGItemStruct*)Weapons.Find(ItemKey);
-		if (ptr != nullptr) return *ptr;
-		else return FRPGItemStruct();
-	}
-	case ERPGItemType::Undefined:
+	const FRPGItemStruct* ptr = FindBaseItem(ItemKey, ItemType);
+	if (ptr != nullptr)
 	{
-		ERPGItemType itemType;
-		FRPGItemStruct itemData;
-		FindItem(ItemKey, itemType, itemData);
-		return itemData;
-	}
+		return *ptr;
 	}
 	return FRPGItemStruct();
 }
 
-bool URPGGameInstanceBase::FindItem(FString ItemKey, ERPGItemType& OutItemType, FRPGItemStruct& OutItemData) const
+bool URPGGameInstanceBase::FindItem(const FString& ItemKey, ERPGItemType& OutItemType, FRPGItemStruct& OutItemData) const
 {
-	FRPGItemStruct* ptr = (FRPGItemStruct*)Potions.Find(ItemKey);
+	FRPGItemId ItemId;
+	const FRPGItemStruct* ptr = FindBaseItem(ItemKey, ERPGItemType::Undefined, &ItemId);
 	if (ptr != nullptr)
 	{
-		OutItemType = ERPGItemType::Potion;
+		OutItemType = ItemId.ItemType;
 		OutItemData = *ptr;
 		return true;
 	}
-	ptr = (FRPGItemStruct*)Skills.Find(ItemKey);
-	if (ptr != nullptr)
+	OutItemType = ERPGItemType::Undefined;
+	OutItemData = FRPGItemStruct();
+	return false;
+}
+
+void URPGGameInstanceBase::GetItemsBaseInfo(ERPGItemType ItemType, TMap<FString, FRPGItemStruct>& OutItems) const
+{
+	OutItems = ItemCatalog.GetBaseInfoView(ItemType);
+}
+
+const TMap<FString, FRPGItemStruct>& URPGGameInstanceBase::GetItemsBaseInfoView(ERPGItemType ItemType) const
+{
+	return ItemCatalog.GetBaseInfoView(ItemType);
+}
+
+int32 URPGGameInstanceBase::GetItemsBaseInfoPage(ERPGItemType ItemType, int32 PageIndex, int32 PageSize, const FString& NameFilter, TArray<FString>& OutKeys, TArray<FRPGItemStruct>& OutItems) const
+{
+	OutKeys.Reset();
+	OutItems.Reset();
+
+	const TMap<FString, FRPGItemStruct>& View = ItemCatalog.GetBaseInfoView(ItemType);
+
+	// A page size of 0 or less returns every matching item
+	const int32 FirstMatch = PageSize > 0 ? FMath::Max(PageIndex, 0) * PageSize : 0;
+	const int32 LastMatch = PageSize > 0 ? FirstMatch + PageSize : MAX_int32;
+	if (PageSize > 0)
 	{
-		OutItemType = ERPGItemType::Skill;
-		OutItemData = *ptr;
-		return true;
+		OutKeys.Reserve(PageSize);
+		OutItems.Reserve(PageSize);
 	}
-	ptr = (FRPGItemStruct*)Tokens.Find(ItemKey);
-	if (ptr != nullptr)
+
+	int32 NumMatches = 0;
+	for (const TPair<FString, FRPGItemStruct>& Pair : View)
 	{
-		OutItemType = ERPGItemType::Token;
-		OutItemData = *ptr;
-		return true;
+		if (!NameFilter.IsEmpty() && !Pair.Key.Contains(NameFilter) && !Pair.Value.ItemName.ToString().Contains(NameFilter))
+		{
+			continue;
+		}
+
+		if (NumMatches >= FirstMatch && NumMatches < LastMatch)
+		{
+			OutKeys.Add(Pair.Key);
+			OutItems.Add(Pair.Value);
+		}
+		NumMatches++;
 	}
-	ptr = (FRPGItemStruct*)Weapons.Find(ItemKey);
+	return NumMatches;
+}
+
+FRPGItemId URPGGameInstanceBase::GetItemId(const FString& ItemKey, ERPGItemType ItemType) const
+{
+	return ItemCatalog.FindItemId(FRPGItemCatalog::MakeKeyName(ItemKey), ItemType);
+}
+
+FString URPGGameInstanceBase::GetItemKeyFromId(FRPGItemId ItemId) const
+{
+	const FName KeyName = ItemCatalog.GetItemKey(ItemId);
+	return KeyName != NAME_None ? KeyName.ToString() : FString();
+}
+
+bool URPGGameInstanceBase::ItemIdExists(FRPGItemId ItemId) const
+{
+	return ItemCatalog.IsValidId(ItemId);
+}
+
+bool URPGGameInstanceBase::TryGetBaseItemDataById(FRPGItemId ItemId, FRPGItemStruct& outItem) const
+{
+	const FRPGItemStruct* ptr = FindBaseItem(ItemId);
 	if (ptr != nullptr)
 	{
-		OutItemType = ERPGItemType::Weapon;
-		OutItemData = *ptr;
+		outItem = *ptr;
 		return true;
 	}
-	OutItemType = ERPGItemType::Undefined;
-	OutItemData = FRPGItemStruct();
+	outItem = FRPGItemStruct();
 	return false;
 }
 
-void URPGGameInstanceBase::GetItemsBaseInfo(ERPGItemType ItemType, TMap<FString, FRPGItemStruct>& OutItems) const
+void URPGGameInstanceBase::RebuildItemCatalog()
 {
-	OutItems = TMap<FString, FRPGItemStruct>();
-	switch (ItemType)
-	{
-	case ERPGItemType::Potion:
+	// Tables are small and only hold soft references, so loading them synchronously does not pull in any item content
+	TArray<const UDataTable*> DefinitionTables;
+	for (const TSoftObjectPtr<UDataTable>& TablePtr : ItemDefinitionTables)
 	{
-		for (TPair<FString, FRPGPotionItemStruct> pair : Potions)
+		if (const UDataTable* Table = TablePtr.LoadSynchronous())
 		{
-			OutItems.Add(pair.Key, (FRPGItemStruct)pair.Value);
+			DefinitionTables.Add(Table);
 		}
-		break;
 	}
-	case ERPGItemType::Skill:
+
+	// Any in flight loads refer to ids from the old catalog, completions that still arrive are ignored by generation
+	for (const TSharedPtr<FStreamableHandle>& Handle : PendingItemAssetLoads)
 	{
-		for (TPair<FString, FRPGSkillItemStruct> pair : Skills)
+		if (Handle.IsValid())
 		{
-			OutItems.Add(pair.Key, (FRPGItemStruct)pair.Value);
+			Handle->CancelHandle();
 		}
-		break;
 	}
-	case ERPGItemType::Token:
+	PendingItemAssetLoads.Reset();
+	ItemCatalogGeneration++;
+
+	ItemCatalog.Build(Potions, Skills, Tokens, Weapons, DefinitionTables);
+}
+
+void URPGGameInstanceBase::RequestItemAssets(const FRPGItemId& ItemId, FStreamableDelegate OnLoaded)
+{
+	TArray<FRPGItemId> ItemIds;
+	ItemIds.Add(ItemId);
+	RequestItemAssets(ItemIds, OnLoaded);
+}
+
+void URPGGameInstanceBase::RequestItemAssets(const TArray<FRPGItemId>& ItemIds, FStreamableDelegate OnLoaded)
+{
+	if (ItemIds.Num() == 0)
+	{
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	TArray<FSoftObjectPath> AssetsToLoad;
+	for (const FRPGItemId& ItemId : ItemIds)
 	{
-		for (TPair<FString, FRPGTokenItemStruct> pair : Tokens)
-		{
-			OutItems.Add(pair.Key, (FRPGItemStruct)pair.Value);
-		}
-		break;
+		ItemCatalog.GetUnloadedAssets(ItemId, AssetsToLoad);
 	}
-	case ERPGItemType::Weapon:
+
+	if (AssetsToLoad.Num() == 0)
 	{
-		for (TPair<FString, FRPGWeaponItemStruct> pair : Weapons)
-		{
-			OutItems.Add(pair.Key, (FRPGItemStruct)pair.Value);
-		}
-		break;
+		// Nothing to stream, but items may have been loaded by something else since the last request
+		OnItemAssetsLoadComplete(ItemIds, OnLoaded, ItemCatalogGeneration);
+		return;
 	}
-	case ERPGItemType::Undefined:
+
+	FStreamableManager& Streamable = UAssetManager::GetStreamableManager();
+	TSharedPtr<FStreamableHandle> Handle = Streamable.RequestAsyncLoad(AssetsToLoad, FStreamableDelegate::CreateUObject(this, &URPGGameInstanceBase::OnItemAssetsLoadComplete, ItemIds, OnLoaded, ItemCatalogGeneration));
+	if (Handle.IsValid())
+	{
+		PendingItemAssetLoads.Add(Handle);
+	}
+}
+
+void URPGGameInstanceBase::OnItemAssetsLoadComplete(TArray<FRPGItemId> ItemIds, FStreamableDelegate OnLoaded, int32 CatalogGeneration)
+{
+	// Drop this and any other finished handle, the loaded assets are kept alive by the catalog from here on
+	PendingItemAssetLoads.RemoveAll([](const TSharedPtr<FStreamableHandle>& Handle)
 	{
-		for (TPair<FString, FRPGPotionItemStruct> pair : Potions)
+		return !Handle.IsValid() || Handle->HasLoadCompleted() || Handle->WasCanceled();
+	});
+
+	// The ids belong to a catalog that has since been rebuilt
+	if (CatalogGeneration != ItemCatalogGeneration)
+	{
+		return;
+	}
+
+	ERPGItemType LoadedType = ItemIds.Num() > 0 ? ItemIds[0].ItemType : ERPGItemType::Undefined;
+	bool bAnyChanged = false;
+	for (const FRPGItemId& ItemId : ItemIds)
+	{
+		bAnyChanged |= ItemCatalog.ApplyLoadedAssets(ItemId);
+		if (ItemId.ItemType != LoadedType)
 		{
-			OutItems.Add(pair.Key, (FRPGItemStruct)pair.Value);
+			LoadedType = ERPGItemType::Undefined;
 		}
-		for (TPair<FString, FRPGSkillItemStruct> pair : Skills)
+	}
+
+	OnLoaded.ExecuteIfBound();
+
+	// Listeners refresh every slot, so only tell them when an item actually gained assets
+	if (bAnyChanged)
+	{
+		OnItemAssetsLoadedNative.Broadcast(LoadedType);
+		OnItemAssetsLoaded.Broadcast(LoadedType);
+	}
+}
+
+void URPGGameInstanceBase::PreloadItemType(ERPGItemType ItemType)
+{
+	const int32 FirstType = ItemType == ERPGItemType::Undefined ? 0 : (int32)ItemType;
+	const int32 LastType = ItemType == ERPGItemType::Undefined ? (int32)ERPGItemType::Undefined - 1 : (int32)ItemType;
+	const int32 BatchSize = FMath::Max(ItemPreloadBatchSize, 1);
+
+	for (int32 TypeIndex = FirstType; TypeIndex <= LastType; TypeIndex++)
+	{
+		// Batch the requests so the first page of a shop screen can show while the rest stream in
+		TArray<FRPGItemId> Batch;
+		Batch.Reserve(BatchSize);
+		const int32 NumItems = ItemCatalog.Num((ERPGItemType)TypeIndex);
+		for (int32 Index = 0; Index < NumItems; Index++)
 		{
-			OutItems.Add(pair.Key, (FRPGItemStruct)pair.Value);
+			const FRPGItemId ItemId((ERPGItemType)TypeIndex, Index);
+			if (ItemCatalog.AreAssetsLoaded(ItemId))
+			{
+				continue;
+			}
+
+			Batch.Add(ItemId);
+			if (Batch.Num() == BatchSize)
+			{
+				RequestItemAssets(Batch);
+				Batch.Reset();
+			}
 		}
-		for (TPair<FString, FRPGTokenItemStruct> pair : Tokens)
+
+		if (Batch.Num() > 0)
 		{
-			OutItems.Add(pair.Key, (FRPGItemStruct)pair.Value);
+			RequestItemAssets(Batch);
 		}
-		for (TPair<FString, FRPGWeaponItemStruct> pair : Weapons)
+	}
+}
+
+void URPGGameInstanceBase::ReleasePreloadedItemType(ERPGItemType ItemType)
+{
+	// Items owned or slotted by any inventory keep their icon, ability and weapon actor
+	TSet<FRPGItemId> ItemsInUse;
+	UWorld* World = GetWorld();
+	if (World)
+	{
+		for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
 		{
-			OutItems.Add(pair.Key, (FRPGItemStruct)pair.Value);
+			const IRPGInventoryInterface* Inventory = Cast<IRPGInventoryInterface>(Iterator->Get());
+			if (!Inventory)
+			{
+				continue;
+			}
+
+			for (const TPair<FString, FRPGItemData>& ItemPair : Inventory->GetInventoryDataMap())
+			{
+				ItemsInUse.Add(GetItemId(ItemPair.Key, ItemPair.Value.ItemType));
+			}
+			for (const TPair<FRPGItemSlot, FString>& SlotPair : Inventory->GetSlottedItemMap())
+			{
+				ItemsInUse.Add(GetItemId(SlotPair.Value, SlotPair.Key.ItemType));
+			}
 		}
-		break;
-	}
 	}
+
+	ItemCatalog.ReleaseLoadedAssets(ItemType, ItemsInUse);
+}
+
+bool URPGGameInstanceBase::AreItemAssetsLoaded(FRPGItemId ItemId) const
+{
+	return ItemCatalog.IsValidId(ItemId) && ItemCatalog.AreAssetsLoaded(ItemId);
 }
 
 bool URPGGameInstanceBase::IsValidItemSlot(FRPGItemSlot ItemSlot) const
@@ -303,9 +440,29 @@ bool URPGGameInstanceBase::IsValidItemSlot(FRPGItemSlot ItemSlot) const
 	return false;
 }
 
+#if WITH_EDITOR
+void URPGGameInstanceBase::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	const FName PropertyName = PropertyChangedEvent.GetPropertyName();
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(URPGGameInstanceBase, Potions)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(URPGGameInstanceBase, Skills)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(URPGGameInstanceBase, Tokens)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(URPGGameInstanceBase, Weapons)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(URPGGameInstanceBase, ItemDefinitionTables))
+	{
+		// Keep the catalog and its indices in sync with edits to the item maps
+		RebuildItemCatalog();
+	}
+}
+#endif
+
 void URPGGameInstanceBase::Init()
 {
 	Super::Init();
+
+	RebuildItemCatalog();
 }
 
 #pragma optimize("", on)
\ No newline at end of file
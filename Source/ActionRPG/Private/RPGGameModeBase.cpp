@@ -3,9 +3,186 @@
 #include "RPGGameModeBase.h"
 #include "RPGGameStateBase.h"
 #include "RPGPlayerControllerBase.h"
+#include "RPGCharacterBase.h"
+#include "RPGEnemyPoolSubsystem.h"
+#include "RPGWeaponPoolSubsystem.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "TimerManager.h"
+#include "Algo/Sort.h"
 
 ARPGGameModeBase::ARPGGameModeBase()
 {
 	GameStateClass = ARPGGameStateBase::StaticClass();
 	PlayerControllerClass = ARPGPlayerControllerBase::StaticClass();
-}
\ No newline at end of file
+
+	SpawnBudgetMs = 2.f;
+	MaxSpawnsPerFrame = 0;
+	SpawnQueueHead = 0;
+	NumWaveSpawned = 0;
+	NumWaveQueued = 0;
+	SpawnQueueSerial = 0;
+}
+
+void ARPGGameModeBase::StartPlay()
+{
+	Super::StartPlay();
+
+	// Fill the weapon pool before the first wave needs it
+	if (URPGWeaponPoolSubsystem* WeaponPool = URPGWeaponPoolSubsystem::Get(this))
+	{
+		WeaponPool->PrewarmFromCatalog();
+	}
+}
+
+void ARPGGameModeBase::QueueWaveSpawns(const TArray<FRPGEnemySpawnRequest>& SpawnRequests)
+{
+	// Order against the view of the first player when queued, so the order doesn't depend on frame timing
+	FVector ViewLocation = FVector::ZeroVector;
+	FVector ViewDirection = FVector::ForwardVector;
+	float CosHalfFOV = -1.f;
+	bool bHasView = false;
+
+	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(this, 0);
+	if (PlayerController && PlayerController->PlayerCameraManager)
+	{
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		ViewDirection = ViewRotation.Vector();
+		CosHalfFOV = FMath::Cos(FMath::DegreesToRadians(PlayerController->PlayerCameraManager->GetFOVAngle() * 0.5f));
+		bHasView = true;
+	}
+
+	// Compact spawned entries away before adding more
+	if (SpawnQueueHead > 0)
+	{
+		SpawnQueue.RemoveAt(0, SpawnQueueHead, false);
+		SpawnQueueHead = 0;
+	}
+
+	const int32 FirstNew = SpawnQueue.Num();
+	SpawnQueue.Reserve(FirstNew + SpawnRequests.Num());
+	for (const FRPGEnemySpawnRequest& Request : SpawnRequests)
+	{
+		if (!Request.CharacterClass)
+		{
+			continue;
+		}
+
+		const FVector ToSpawn = Request.SpawnTransform.GetLocation() - ViewLocation;
+
+		FQueuedSpawn& Queued = SpawnQueue.AddDefaulted_GetRef();
+		Queued.Request = Request;
+		Queued.DistanceSquared = bHasView ? ToSpawn.SizeSquared() : 0.f;
+		Queued.Sequence = NumWaveQueued++;
+		Queued.bOnCamera = bHasView && (ToSpawn.GetSafeNormal() | ViewDirection) >= CosHalfFOV;
+	}
+
+	// Later requests are sorted in with the ones still waiting, the sequence keeps ties in queue order
+	Algo::Sort(SpawnQueue, [](const FQueuedSpawn& A, const FQueuedSpawn& B)
+	{
+		if (A.Request.Priority != B.Request.Priority)
+		{
+			return A.Request.Priority > B.Request.Priority;
+		}
+		if (A.bOnCamera != B.bOnCamera)
+		{
+			return !A.bOnCamera;
+		}
+		if (A.DistanceSquared != B.DistanceSquared)
+		{
+			return A.DistanceSquared < B.DistanceSquared;
+		}
+		return A.Sequence < B.Sequence;
+	});
+
+	if (IsSpawningWave())
+	{
+		ScheduleSpawnQueue();
+	}
+}
+
+void ARPGGameModeBase::ScheduleSpawnQueue()
+{
+	// Uses a timer rather than the actor tick so blueprint subclasses keep their own Event Tick
+	if (!SpawnQueueTimerHandle.IsValid())
+	{
+		SpawnQueueTimerHandle = GetWorldTimerManager().SetTimerForNextTick(this, &ARPGGameModeBase::ProcessSpawnQueue);
+	}
+}
+
+void ARPGGameModeBase::CancelWaveSpawns()
+{
+	SpawnQueue.Reset();
+	SpawnQueueHead = 0;
+	NumWaveSpawned = 0;
+	NumWaveQueued = 0;
+	SpawnQueueSerial++;
+	GetWorldTimerManager().ClearTimer(SpawnQueueTimerHandle);
+}
+
+bool ARPGGameModeBase::IsSpawningWave() const
+{
+	return SpawnQueueHead < SpawnQueue.Num();
+}
+
+void ARPGGameModeBase::ProcessSpawnQueue()
+{
+	SpawnQueueTimerHandle.Invalidate();
+
+	URPGEnemyPoolSubsystem* EnemyPool = URPGEnemyPoolSubsystem::Get(this);
+	if (!EnemyPool || !IsSpawningWave())
+	{
+		CancelWaveSpawns();
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = SpawnBudgetMs * 0.001;
+	int32 NumSpawnedThisFrame = 0;
+	const int32 Serial = SpawnQueueSerial;
+
+	while (IsSpawningWave())
+	{
+		if (NumSpawnedThisFrame > 0)
+		{
+			if ((MaxSpawnsPerFrame > 0 && NumSpawnedThisFrame >= MaxSpawnsPerFrame)
+				|| (SpawnBudgetMs > 0.f && FPlatformTime::Seconds() - StartTime >= BudgetSeconds))
+			{
+				break;
+			}
+		}
+
+		// Copy out, delegates below may queue more spawns and reallocate the queue
+		const FRPGEnemySpawnRequest Request = SpawnQueue[SpawnQueueHead++].Request;
+		NumSpawnedThisFrame++;
+		NumWaveSpawned++;
+
+		if (ARPGCharacterBase* Enemy = EnemyPool->AcquireEnemy(Request.CharacterClass, Request.SpawnTransform, Request.CharacterLevel))
+		{
+			OnWaveEnemySpawned.Broadcast(Enemy);
+
+			// A handler cancelled the wave, it gets no progress or finish events
+			if (Serial != SpawnQueueSerial)
+			{
+				return;
+			}
+		}
+	}
+
+	OnWaveSpawnProgress.Broadcast(NumWaveSpawned, NumWaveQueued);
+	if (Serial != SpawnQueueSerial)
+	{
+		return;
+	}
+
+	if (!IsSpawningWave())
+	{
+		CancelWaveSpawns();
+		OnWaveSpawnFinished.Broadcast();
+	}
+	else
+	{
+		ScheduleSpawnQueue();
+	}
+}
@@ -0,0 +1,95 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "RPGInventorySlots.h"
+
+void FRPGInventorySlots::Init(const TMap<ERPGItemType, int32>& SlotsPerItemType)
+{
+	Reset();
+
+	for (const TPair<ERPGItemType, int32>& Pair : SlotsPerItemType)
+	{
+		if (Pair.Key >= ERPGItemType::Undefined || Pair.Value <= 0)
+		{
+			continue;
+		}
+
+		const int32 TypeIndex = (int32)Pair.Key;
+		Slots[TypeIndex].SetNum(Pair.Value);
+		FreeSlots[TypeIndex].Init(true, Pair.Value);
+	}
+}
+
+void FRPGInventorySlots::Reset()
+{
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		Slots[TypeIndex].Reset();
+		FreeSlots[TypeIndex].Empty();
+	}
+	ItemToSlot.Reset();
+}
+
+const FString& FRPGInventorySlots::GetItem(const FRPGItemSlot& ItemSlot) const
+{
+	static const FString EmptyKey;
+	return IsValidSlot(ItemSlot) ? Slots[(int32)ItemSlot.ItemType][ItemSlot.SlotNumber] : EmptyKey;
+}
+
+FRPGItemSlot FRPGInventorySlots::FindItemSlot(const FString& ItemKey) const
+{
+	if (ItemKey.IsEmpty())
+	{
+		return FRPGItemSlot();
+	}
+
+	// A key that was never interned can't have been slotted
+	const FName KeyName(*ItemKey, FNAME_Find);
+	const FRPGItemSlot* FoundSlot = KeyName.IsNone() ? nullptr : ItemToSlot.Find(KeyName);
+	return FoundSlot ? *FoundSlot : FRPGItemSlot();
+}
+
+FRPGItemSlot FRPGInventorySlots::FindFreeSlot(ERPGItemType ItemType) const
+{
+	if (ItemType >= ERPGItemType::Undefined)
+	{
+		return FRPGItemSlot();
+	}
+
+	const int32 SlotNumber = FreeSlots[(int32)ItemType].Find(true);
+	return SlotNumber != INDEX_NONE ? FRPGItemSlot(ItemType, SlotNumber) : FRPGItemSlot();
+}
+
+bool FRPGInventorySlots::SetItem(const FRPGItemSlot& ItemSlot, const FString& ItemKey)
+{
+	if (!IsValidSlot(ItemSlot))
+	{
+		return false;
+	}
+
+	const int32 TypeIndex = (int32)ItemSlot.ItemType;
+	FString& SlotItem = Slots[TypeIndex][ItemSlot.SlotNumber];
+	if (SlotItem == ItemKey)
+	{
+		return false;
+	}
+
+	if (!SlotItem.IsEmpty())
+	{
+		// Only drop the reverse entry if it points here, replicated slot changes can arrive in any order
+		const FName OldKeyName(*SlotItem, FNAME_Find);
+		const FRPGItemSlot* MappedSlot = ItemToSlot.Find(OldKeyName);
+		if (MappedSlot && *MappedSlot == ItemSlot)
+		{
+			ItemToSlot.Remove(OldKeyName);
+		}
+	}
+
+	SlotItem = ItemKey;
+	FreeSlots[TypeIndex][ItemSlot.SlotNumber] = ItemKey.IsEmpty();
+
+	if (!ItemKey.IsEmpty())
+	{
+		ItemToSlot.Add(FName(*ItemKey), ItemSlot);
+	}
+	return true;
+}
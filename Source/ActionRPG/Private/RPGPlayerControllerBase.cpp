@@ -3,6 +3,9 @@
 #include "RPGPlayerControllerBase.h"
 #include "RPGCharacterBase.h"
 #include "RPGGameInstanceBase.h"
+#include "RPGSaveGame.h"
+#include "Kismet/GameplayStatics.h"
+#include "Async/Async.h"
 
 // LA -
 // Prevents code optimisation which is useful for stepping through as it means
@@ -11,9 +14,26 @@
 // See: https://docs.microsoft.com/en-us/cpp/preprocessor/optimize?view=msvc-160
 #pragma optimize("", off)
 
+ARPGPlayerControllerBase::ARPGPlayerControllerBase()
+	: InventoryTransactionDepth(0)
+	, InventoryRevision(0)
+	, SavedInventoryRevision(0)
+	, bInventorySaveInProgress(false)
+	, bInventorySaveQueued(false)
+	, GameInstance(nullptr)
+{
+	ReplicatedInventory.Owner = this;
+	ReplicatedSlots.Owner = this;
+}
+
 bool ARPGPlayerControllerBase::AddInventoryItem(FString NewItemKey, ERPGItemType ItemType, int32 ItemCount, int32 ItemLevel, bool bAutoSlot)
 {
 	bool bChanged = false;
+	if (!CheckInventoryAuthority(TEXT("AddInventoryItem")))
+	{
+		return false;
+	}
+
 	if (NewItemKey.IsEmpty() || ItemType == ERPGItemType::Undefined)
 	{
 		UE_LOG(LogActionRPG, Warning, TEXT("AddInventoryItem: Failed trying to add null item!"));
@@ -26,7 +46,9 @@ bool ARPGPlayerControllerBase::AddInventoryItem(FString NewItemKey, ERPGItemType
 		return false;
 	}
 
-	if (!GetGameInstance() || !GetGameInstance()->ItemExists(NewItemKey, ItemType))
+	FRPGItemId ItemId;
+	const FRPGItemStruct* itemData = GetGameInstance() ? GetGameInstance()->FindBaseItem(NewItemKey, ItemType, &ItemId) : nullptr;
+	if (!itemData)
 	{
 		UE_LOG(LogActionRPG, Warning, TEXT("AddInventoryItem: Failed trying to add item %s could not find on game instance!"), *NewItemKey);
 		return false;
@@ -36,18 +58,22 @@ bool ARPGPlayerControllerBase::AddInventoryItem(FString NewItemKey, ERPGItemType
 	FRPGItemData OldData;
 	GetInventoryItemData(NewItemKey, OldData);
 
-	FRPGItemStruct itemData = GetGameInstance()->GetBaseItemData(NewItemKey, ItemType);
-
 	// Find modified data
 	FRPGItemData NewData = OldData;
-	NewData.UpdateItemData(FRPGItemData(ItemCount, ItemLevel, ItemType), itemData.MaxCount, itemData.MaxLevel);
+	NewData.UpdateItemData(FRPGItemData(ItemCount, ItemLevel, ItemType), itemData->MaxCount, itemData->MaxLevel);
 
 	if (OldData != NewData)
 	{
 		// If data changed, need to update storage and call callback
-		InventoryData.Add(NewItemKey, NewData);
+		SetInventoryItemData(NewItemKey, NewData);
 		NotifyInventoryItemChanged(true, NewItemKey, ItemType);
 		bChanged = true;
+
+		// Owned items need their icon and ability, stream them in if they came from a definition table
+		if (!OldData.IsValid())
+		{
+			GetGameInstance()->RequestItemAssets(ItemId);
+		}
 	}
 
 	if (bAutoSlot)
@@ -65,6 +91,17 @@ bool ARPGPlayerControllerBase::AddInventoryItem(FString NewItemKey, ERPGItemType
 
 bool ARPGPlayerControllerBase::RemoveInventoryItem(FString RemovedItemKey, int32 RemoveCount)
 {
+	if (ShouldForwardInventoryChange())
+	{
+		ServerRemoveInventoryItem(RemovedItemKey, RemoveCount);
+		return false;
+	}
+
+	if (!CheckInventoryAuthority(TEXT("RemoveInventoryItem")))
+	{
+		return false;
+	}
+
 	if (RemovedItemKey.IsEmpty())
 	{
 		UE_LOG(LogActionRPG, Warning, TEXT("RemoveInventoryItem: Failed trying to remove null item!"));
@@ -94,20 +131,18 @@ bool ARPGPlayerControllerBase::RemoveInventoryItem(FString RemovedItemKey, int32
 	if (NewData.ItemCount > 0)
 	{
 		// Update data with new count
-		InventoryData.Add(RemovedItemKey, NewData);
+		SetInventoryItemData(RemovedItemKey, NewData);
 	}
 	else
 	{
 		// Remove item entirely, make sure it is unslotted
-		InventoryData.Remove(RemovedItemKey);
+		RemoveInventoryItemData(RemovedItemKey);
 
-		for (TPair<FRPGItemSlot, FString>& Pair : SlottedItems)
+		const FRPGItemSlot OldSlot = InventorySlots.FindItemSlot(RemovedItemKey);
+		if (OldSlot.IsValid())
 		{
-			if (Pair.Value == RemovedItemKey)
-			{
-				Pair.Value = nullptr;
-				NotifySlottedItemChanged(Pair.Key, Pair.Value, Pair.Key.ItemType);
-			}
+			SetSlotContents(OldSlot, FString());
+			NotifySlottedItemChanged(OldSlot, FString(), OldSlot.ItemType);
 		}
 	}
 
@@ -116,6 +151,52 @@ bool ARPGPlayerControllerBase::RemoveInventoryItem(FString RemovedItemKey, int32
 	return true;
 }
 
+bool ARPGPlayerControllerBase::PurchaseItem(FString ItemKey, ERPGItemType ItemType, bool bAutoSlot)
+{
+	if (ShouldForwardInventoryChange())
+	{
+		ServerPurchaseItem(ItemKey, ItemType, bAutoSlot);
+		return false;
+	}
+
+	if (!CheckInventoryAuthority(TEXT("PurchaseItem")) || !GetGameInstance())
+	{
+		return false;
+	}
+
+	const FString& TokenKey = GetGameInstance()->PurchaseTokenKey;
+	const FRPGItemStruct* itemData = GetGameInstance()->FindBaseItem(ItemKey, ItemType);
+	if (!itemData || TokenKey.IsEmpty() || ItemKey == TokenKey)
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("PurchaseItem: Item %s can not be purchased!"), *ItemKey);
+		return false;
+	}
+
+	const int32 Price = FMath::Max(itemData->Price, 0);
+	if (GetInventoryItemCount(TokenKey) < Price)
+	{
+		return false;
+	}
+
+	// Charge only if the item was actually added, an item already at its max count is not bought again
+	BeginInventoryTransaction();
+	const bool bAdded = AddInventoryItem(ItemKey, ItemType, 1, 1, false);
+	if (bAdded)
+	{
+		if (Price > 0)
+		{
+			RemoveInventoryItem(TokenKey, Price);
+		}
+		if (bAutoSlot)
+		{
+			FillEmptySlotWithItem(ItemKey, ItemType);
+		}
+	}
+	CommitInventoryTransaction();
+
+	return bAdded;
+}
+
 void ARPGPlayerControllerBase::GetInventoryItems(TArray<FString>& Items, ERPGItemType ItemType)
 {
 	for (const TPair<FString, FRPGItemData>& Pair : InventoryData)
@@ -129,30 +210,32 @@ void ARPGPlayerControllerBase::GetInventoryItems(TArray<FString>& Items, ERPGIte
 
 bool ARPGPlayerControllerBase::SetSlottedItem(FRPGItemSlot ItemSlot, FString ItemKey)
 {
-	// Iterate entire inventory because we need to remove from old slot
-	bool bFound = false;
-	for (TPair<FRPGItemSlot, FString>& Pair : SlottedItems)
+	if (ShouldForwardInventoryChange())
 	{
-		if (Pair.Key == ItemSlot)
-		{
-			// Add to new slot
-			bFound = true;
-			Pair.Value = ItemKey;
-			NotifySlottedItemChanged(Pair.Key, Pair.Value, Pair.Key.ItemType);
-		}
-		else if (!ItemKey.IsEmpty() && Pair.Value == ItemKey)
-		{
-			// If this item was found in another slot, remove it
-			Pair.Value = "";
-			NotifySlottedItemChanged(Pair.Key, Pair.Value, Pair.Key.ItemType);
-		}
+		ServerSetSlottedItem(ItemSlot, ItemKey);
+		return false;
 	}
 
-	if (bFound)
+	if (!CheckInventoryAuthority(TEXT("SetSlottedItem")) || !InventorySlots.IsValidSlot(ItemSlot))
 	{
-		return true;
+		return false;
 	}
-	return false;
+
+	if (!ItemKey.IsEmpty())
+	{
+		// If this item was found in another slot, remove it
+		const FRPGItemSlot OldSlot = InventorySlots.FindItemSlot(ItemKey);
+		if (OldSlot.IsValid() && OldSlot != ItemSlot)
+		{
+			SetSlotContents(OldSlot, FString());
+			NotifySlottedItemChanged(OldSlot, FString(), OldSlot.ItemType);
+		}
+	}
+
+	// Add to new slot
+	SetSlotContents(ItemSlot, ItemKey);
+	NotifySlottedItemChanged(ItemSlot, ItemKey, ItemSlot.ItemType);
+	return true;
 }
 
 int32 ARPGPlayerControllerBase::GetInventoryItemCount(FString ItemKey) const
@@ -181,18 +264,16 @@ bool ARPGPlayerControllerBase::GetInventoryItemData(FString ItemKey, FRPGItemDat
 
 FString ARPGPlayerControllerBase::GetSlottedItem(FRPGItemSlot ItemSlot, FRPGItemStruct& OutItemData) const
 {
-	const FString* FoundItem = SlottedItems.Find(ItemSlot);
+	const FString& FoundItem = InventorySlots.GetItem(ItemSlot);
 
-	if (FoundItem)
+	// Empty slots are the common case, skip the catalog entirely for them
+	if (!FoundItem.IsEmpty())
 	{
-		ERPGItemType itemType;
 		UWorld* World = GetWorld();
 		URPGGameInstanceBase* gi = World ? World->GetGameInstance<URPGGameInstanceBase>() : nullptr;
-		if (!gi || !gi->FindItem(*FoundItem, itemType, OutItemData))
-		{
-			OutItemData = FRPGItemStruct();
-		}
-		return *FoundItem;
+		const FRPGItemStruct* itemData = gi ? gi->FindBaseItem(FoundItem, ERPGItemType::Undefined) : nullptr;
+		OutItemData = itemData ? *itemData : FRPGItemStruct();
+		return FoundItem;
 	}
 	OutItemData = FRPGItemStruct();
 	return "";
@@ -200,17 +281,22 @@ FString ARPGPlayerControllerBase::GetSlottedItem(FRPGItemSlot ItemSlot, FRPGItem
 
 void ARPGPlayerControllerBase::GetSlottedItems(TArray<FString>& Items, ERPGItemType ItemType, bool bOutputEmptyIndexes)
 {
-	for (TPair<FRPGItemSlot, FString>& Pair : SlottedItems)
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
 	{
-		if (Pair.Key.ItemType == ItemType || ItemType == ERPGItemType::Undefined)
+		if ((ERPGItemType)TypeIndex == ItemType || ItemType == ERPGItemType::Undefined)
 		{
-			Items.Add(Pair.Value);
+			Items.Append(InventorySlots.GetSlots((ERPGItemType)TypeIndex));
 		}
 	}
 }
 
 void ARPGPlayerControllerBase::FillEmptySlots()
 {
+	if (!CheckInventoryAuthority(TEXT("FillEmptySlots")))
+	{
+		return;
+	}
+
 	for (const TPair<FString, FRPGItemData>& Pair : InventoryData)
 	{
 		FillEmptySlotWithItem(Pair.Key, Pair.Value.ItemType);
@@ -219,32 +305,375 @@ void ARPGPlayerControllerBase::FillEmptySlots()
 
 void ARPGPlayerControllerBase::InitInventory()
 {
+	if (!CheckInventoryAuthority(TEXT("InitInventory")))
+	{
+		return;
+	}
+
 	InventoryData.Reset();
-	SlottedItems.Reset();
+	ReplicatedInventory.Reset();
+	InitInventorySlots();
 
 	if (!GetGameInstance())
 	{
 		return;
 	}
 
-	for (const TPair<ERPGItemType, int32>& Pair : GetGameInstance()->SlotsPerItemType)
+	// The loaded notification covers every change made while filling the inventory
+	BeginInventoryTransaction();
+
+	FRPGInventorySaveData SaveData;
+	const bool bLoadedSave = LoadInventorySaveData(SaveData);
+	if (bLoadedSave)
+	{
+		// Copy from save game into controller data
+		ApplyInventorySaveData(SaveData);
+	}
+	else
 	{
-		for (int32 SlotNumber = 0; SlotNumber < Pair.Value; SlotNumber++)
+		for (const TPair<FString, FRPGItemData>& ItemPair : GetGameInstance()->DefaultInventoryItems)
 		{
-			SlottedItems.Add(FRPGItemSlot(Pair.Key, SlotNumber), "");
+			SetInventoryItemData(ItemPair.Key, ItemPair.Value);
 		}
+		FillEmptySlots();
 	}
 
-	// Copy from save game into controller data
-	for (const TPair<FString, FRPGItemData>& ItemPair : GetGameInstance()->DefaultInventoryItems)
+	PendingChangeSet.Reset();
+	CommitInventoryTransaction();
+
+	// Request every owned item in one load, characters refresh their abilities when it completes
+	TArray<FRPGItemId> OwnedItemIds;
+	for (const TPair<FString, FRPGItemData>& ItemPair : InventoryData)
 	{
-		InventoryData.Add(ItemPair.Key, ItemPair.Value);
+		OwnedItemIds.Add(GetGameInstance()->GetItemId(ItemPair.Key, ItemPair.Value.ItemType));
+	}
+	GetGameInstance()->RequestItemAssets(OwnedItemIds);
+
+	if (bLoadedSave)
+	{
+		// What was just loaded matches the save
+		SavedInventoryRevision = InventoryRevision;
 	}
 
-	FillEmptySlots();
 	NotifyInventoryLoaded();
 }
 
+void ARPGPlayerControllerBase::InitInventorySlots()
+{
+	SlottedItems.Reset();
+	InventorySlots.Reset();
+	if (HasAuthority())
+	{
+		ReplicatedSlots.Reset();
+	}
+
+	if (!GetGameInstance())
+	{
+		return;
+	}
+
+	InventorySlots.Init(GetGameInstance()->SlotsPerItemType);
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		for (int32 SlotNumber = 0; SlotNumber < InventorySlots.Num((ERPGItemType)TypeIndex); SlotNumber++)
+		{
+			const FRPGItemSlot ItemSlot((ERPGItemType)TypeIndex, SlotNumber);
+			SlottedItems.Add(ItemSlot, "");
+			if (HasAuthority())
+			{
+				ReplicatedSlots.SetSlot(ItemSlot, FString());
+			}
+		}
+	}
+}
+
+bool ARPGPlayerControllerBase::SaveInventory()
+{
+	// The save slot on the game instance belongs to the local user, remote players on a listen server must not write over it
+	if (!CheckInventoryAuthority(TEXT("SaveInventory")) || !GetGameInstance() || !IsLocalController())
+	{
+		return false;
+	}
+
+	if (bInventorySaveInProgress)
+	{
+		// Only one save at a time, the latest state is saved once the current one is written
+		bInventorySaveQueued = true;
+		return true;
+	}
+
+	if (!IsInventoryDirty())
+	{
+		return false;
+	}
+
+	FRPGInventorySaveData SaveData;
+	MakeInventorySaveData(SaveData);
+
+	const int32 Revision = InventoryRevision;
+	bInventorySaveInProgress = true;
+
+	// Encode on a worker, then hand the bytes back to the game thread to start the async write
+	TWeakObjectPtr<ARPGPlayerControllerBase> WeakThis(this);
+	Async(EAsyncExecution::ThreadPool, [WeakThis, SaveData = MoveTemp(SaveData), Revision]()
+	{
+		TArray<uint8> Bytes;
+		SaveData.Encode(Bytes);
+#if DO_CHECK
+		ensureMsgf(SaveData.RoundTrips(Bytes), TEXT("SaveInventory: Encoded inventory does not decode to the same data"));
+#endif
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Bytes = MoveTemp(Bytes), Revision]() mutable
+		{
+			if (ARPGPlayerControllerBase* Controller = WeakThis.Get())
+			{
+				Controller->OnInventorySaveEncoded(MoveTemp(Bytes), Revision);
+			}
+		});
+	});
+
+	return true;
+}
+
+void ARPGPlayerControllerBase::OnInventorySaveEncoded(TArray<uint8>&& Bytes, int32 Revision)
+{
+	URPGSaveGame* SaveGame = Cast<URPGSaveGame>(UGameplayStatics::CreateSaveGameObject(URPGSaveGame::StaticClass()));
+	if (!SaveGame || !GetGameInstance())
+	{
+		OnInventorySaveComplete(FString(), 0, false, Revision);
+		return;
+	}
+
+	SaveGame->InventoryBlob = MoveTemp(Bytes);
+	UGameplayStatics::AsyncSaveGameToSlot(SaveGame, GetGameInstance()->SaveSlot, GetGameInstance()->SaveUserIndex,
+		FAsyncSaveGameToSlotDelegate::CreateUObject(this, &ARPGPlayerControllerBase::OnInventorySaveComplete, Revision));
+}
+
+void ARPGPlayerControllerBase::OnInventorySaveComplete(const FString& SlotName, const int32 UserIndex, bool bSuccess, int32 Revision)
+{
+	bInventorySaveInProgress = false;
+
+	if (bSuccess)
+	{
+		SavedInventoryRevision = Revision;
+	}
+	else
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("SaveInventory: Failed to write save slot %s!"), *SlotName);
+	}
+
+	InventorySaved(bSuccess);
+
+	if (bInventorySaveQueued)
+	{
+		bInventorySaveQueued = false;
+		SaveInventory();
+	}
+}
+
+void ARPGPlayerControllerBase::MakeInventorySaveData(FRPGInventorySaveData& OutData)
+{
+	const FRPGItemCatalog& Catalog = GetGameInstance()->GetItemCatalog();
+	OutData.CatalogFingerprint = Catalog.GetFingerprint();
+
+	TMap<FString, int32> ItemIndices;
+	ItemIndices.Reserve(InventoryData.Num());
+	OutData.ItemKeys.Reserve(InventoryData.Num());
+	OutData.ItemIds.Reserve(InventoryData.Num());
+	OutData.Items.Reserve(InventoryData.Num());
+
+	for (const TPair<FString, FRPGItemData>& Pair : InventoryData)
+	{
+		ItemIndices.Add(Pair.Key, OutData.Items.Num());
+		OutData.ItemKeys.Add(Pair.Key);
+		OutData.ItemIds.Add(Catalog.FindItemId(FRPGItemCatalog::MakeKeyName(Pair.Key), Pair.Value.ItemType));
+		OutData.Items.Add(Pair.Value);
+	}
+
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		const TArray<FString>& TypeSlots = InventorySlots.GetSlots((ERPGItemType)TypeIndex);
+		TArray<int32>& SlotItems = OutData.SlotItems[TypeIndex];
+		SlotItems.Reset(TypeSlots.Num());
+		for (const FString& SlotItem : TypeSlots)
+		{
+			const int32* ItemIndex = SlotItem.IsEmpty() ? nullptr : ItemIndices.Find(SlotItem);
+			SlotItems.Add(ItemIndex ? *ItemIndex : INDEX_NONE);
+		}
+	}
+}
+
+bool ARPGPlayerControllerBase::LoadInventorySaveData(FRPGInventorySaveData& OutData)
+{
+	// Remote players start with the default inventory rather than the save of the local user
+	if (!GetGameInstance() || !IsLocalController() || !UGameplayStatics::DoesSaveGameExist(GetGameInstance()->SaveSlot, GetGameInstance()->SaveUserIndex))
+	{
+		return false;
+	}
+
+	URPGSaveGame* SaveGame = Cast<URPGSaveGame>(UGameplayStatics::LoadGameFromSlot(GetGameInstance()->SaveSlot, GetGameInstance()->SaveUserIndex));
+	if (!SaveGame || SaveGame->SavedDataVersion < ERPGSaveGameVersion::InventoryBlob || !OutData.Decode(SaveGame->InventoryBlob, GetGameInstance()->GetItemCatalog().GetFingerprint()))
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("InitInventory: Save slot %s has no readable inventory, using defaults"), *GetGameInstance()->SaveSlot);
+		return false;
+	}
+	return true;
+}
+
+void ARPGPlayerControllerBase::ApplyInventorySaveData(const FRPGInventorySaveData& Data)
+{
+	const FRPGItemCatalog& Catalog = GetGameInstance()->GetItemCatalog();
+
+	// Ids can be trusted as long as the catalog has the same layout, otherwise fall back to resolving keys
+	const bool bIdsValid = Data.CatalogFingerprint == Catalog.GetFingerprint();
+
+	TBitArray<> LoadedItems(false, Data.Items.Num());
+	TArray<FString> ItemKeys;
+	ItemKeys.SetNum(Data.Items.Num());
+	for (int32 Index = 0; Index < Data.Items.Num(); Index++)
+	{
+		// The decoder leaves out the keys when the ids are valid, the catalog has them
+		const FRPGItemData& ItemData = Data.Items[Index];
+		const FRPGItemId ItemId = bIdsValid ? Data.ItemIds[Index] : Catalog.FindItemId(FRPGItemCatalog::MakeKeyName(Data.ItemKeys[Index]), ItemData.ItemType);
+
+		if (!Catalog.IsValidId(ItemId) || !ItemData.IsValid())
+		{
+			UE_LOG(LogActionRPG, Warning, TEXT("InitInventory: Dropping saved item %s, it is no longer in the catalog!"), Data.ItemKeys.IsValidIndex(Index) ? *Data.ItemKeys[Index] : TEXT("(unknown)"));
+			continue;
+		}
+
+		ItemKeys[Index] = Data.ItemKeys.IsValidIndex(Index) ? Data.ItemKeys[Index] : Catalog.GetItemKey(ItemId).ToString();
+		SetInventoryItemData(ItemKeys[Index], ItemData);
+		LoadedItems[Index] = true;
+	}
+
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		const int32 NumSlots = FMath::Min(Data.SlotItems[TypeIndex].Num(), InventorySlots.Num((ERPGItemType)TypeIndex));
+		for (int32 SlotNumber = 0; SlotNumber < NumSlots; SlotNumber++)
+		{
+			const int32 ItemIndex = Data.SlotItems[TypeIndex][SlotNumber];
+			if (ItemIndex != INDEX_NONE && LoadedItems[ItemIndex])
+			{
+				SetSlotContents(FRPGItemSlot((ERPGItemType)TypeIndex, SlotNumber), ItemKeys[ItemIndex]);
+			}
+		}
+	}
+}
+
+bool ARPGPlayerControllerBase::CheckInventoryAuthority(const TCHAR* FunctionName) const
+{
+	if (!HasAuthority())
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("%s: Inventory can only be modified with authority!"), FunctionName);
+		return false;
+	}
+	return true;
+}
+
+bool ARPGPlayerControllerBase::ShouldForwardInventoryChange() const
+{
+	return !HasAuthority() && IsLocalController();
+}
+
+void ARPGPlayerControllerBase::ServerPurchaseItem_Implementation(const FString& ItemKey, ERPGItemType ItemType, bool bAutoSlot)
+{
+	// Price and token count are checked here on the server, the client only names the item
+	PurchaseItem(ItemKey, ItemType, bAutoSlot);
+}
+
+bool ARPGPlayerControllerBase::ServerPurchaseItem_Validate(const FString& ItemKey, ERPGItemType ItemType, bool bAutoSlot)
+{
+	// Unknown or unaffordable items are rejected with a warning by PurchaseItem, only drop clients sending impossible values
+	return !ItemKey.IsEmpty() && ItemType < ERPGItemType::Undefined;
+}
+
+void ARPGPlayerControllerBase::ServerRemoveInventoryItem_Implementation(const FString& RemovedItemKey, int32 RemoveCount)
+{
+	// Clients can only give up items they own, RemoveInventoryItem does nothing for anything else
+	RemoveInventoryItem(RemovedItemKey, RemoveCount);
+}
+
+bool ARPGPlayerControllerBase::ServerRemoveInventoryItem_Validate(const FString& RemovedItemKey, int32 RemoveCount)
+{
+	return !RemovedItemKey.IsEmpty();
+}
+
+void ARPGPlayerControllerBase::ServerSetSlottedItem_Implementation(FRPGItemSlot ItemSlot, const FString& ItemKey)
+{
+	// Only items the player owns can be equipped, the client may be ahead of replication but never ahead of the server
+	if (!ItemKey.IsEmpty() && !InventoryData.Contains(ItemKey))
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("ServerSetSlottedItem: Item %s is not in the inventory!"), *ItemKey);
+		return;
+	}
+
+	SetSlottedItem(ItemSlot, ItemKey);
+}
+
+bool ARPGPlayerControllerBase::ServerSetSlottedItem_Validate(FRPGItemSlot ItemSlot, const FString& ItemKey)
+{
+	return ItemSlot.ItemType < ERPGItemType::Undefined && ItemSlot.SlotNumber >= 0;
+}
+
+void ARPGPlayerControllerBase::SetInventoryItemData(const FString& ItemKey, const FRPGItemData& ItemData)
+{
+	InventoryData.Add(ItemKey, ItemData);
+	ReplicatedInventory.SetItem(ItemKey, ItemData);
+	InventoryRevision++;
+}
+
+void ARPGPlayerControllerBase::RemoveInventoryItemData(const FString& ItemKey)
+{
+	InventoryData.Remove(ItemKey);
+	ReplicatedInventory.RemoveItem(ItemKey);
+	InventoryRevision++;
+}
+
+void ARPGPlayerControllerBase::OnReplicatedItemChanged(const FString& ItemKey, const FRPGItemData& ItemData)
+{
+	const FRPGItemData* OldData = InventoryData.Find(ItemKey);
+	const bool bAdded = !OldData || ItemData.ItemCount >= OldData->ItemCount;
+	const bool bNewItem = !OldData;
+
+	InventoryData.Add(ItemKey, ItemData);
+
+	if (bNewItem && GetGameInstance())
+	{
+		GetGameInstance()->RequestItemAssets(GetGameInstance()->GetItemId(ItemKey, ItemData.ItemType));
+	}
+
+	NotifyInventoryItemChanged(bAdded, ItemKey, ItemData.ItemType);
+}
+
+void ARPGPlayerControllerBase::OnReplicatedItemRemoved(const FString& ItemKey)
+{
+	FRPGItemData OldData;
+	if (InventoryData.RemoveAndCopyValue(ItemKey, OldData))
+	{
+		NotifyInventoryItemChanged(false, ItemKey, OldData.ItemType);
+	}
+}
+
+void ARPGPlayerControllerBase::OnReplicatedSlotChanged(const FRPGItemSlot& ItemSlot, const FString& ItemKey)
+{
+	if (!InventorySlots.IsValidSlot(ItemSlot))
+	{
+		// Slots may replicate before BeginPlay has set them up
+		InitInventorySlots();
+		if (!InventorySlots.IsValidSlot(ItemSlot))
+		{
+			return;
+		}
+	}
+
+	if (InventorySlots.GetItem(ItemSlot) != ItemKey)
+	{
+		SetSlotContents(ItemSlot, ItemKey);
+		NotifySlottedItemChanged(ItemSlot, ItemKey, ItemSlot.ItemType);
+	}
+}
+
 URPGGameInstanceBase* ARPGPlayerControllerBase::GetGameInstance()
 {
 	if (GameInstance == nullptr)
@@ -257,27 +686,16 @@ URPGGameInstanceBase* ARPGPlayerControllerBase::GetGameInstance()
 
 bool ARPGPlayerControllerBase::FillEmptySlotWithItem(FString NewItemKey, ERPGItemType ItemType)
 {
-	FRPGItemSlot EmptySlot;
-	for (TPair<FRPGItemSlot, FString>& Pair : SlottedItems)
+	if (InventorySlots.FindItemSlot(NewItemKey).IsValid())
 	{
-		if (Pair.Key.ItemType == ItemType)
-		{
-			if (Pair.Value == NewItemKey)
-			{
-				// Item is already slotted
-				return false;
-			}
-			else if (Pair.Value.IsEmpty() && (!EmptySlot.IsValid() || EmptySlot.SlotNumber > Pair.Key.SlotNumber))
-			{
-				// We found an empty slot worth filling
-				EmptySlot = Pair.Key;
-			}
-		}
+		// Item is already slotted
+		return false;
 	}
 
+	const FRPGItemSlot EmptySlot = InventorySlots.FindFreeSlot(ItemType);
 	if (EmptySlot.IsValid())
 	{
-		SlottedItems[EmptySlot] = NewItemKey;
+		SetSlotContents(EmptySlot, NewItemKey);
 		NotifySlottedItemChanged(EmptySlot, NewItemKey, ItemType);
 		return true;
 	}
@@ -285,8 +703,29 @@ bool ARPGPlayerControllerBase::FillEmptySlotWithItem(FString NewItemKey, ERPGIte
 	return false;
 }
 
+void ARPGPlayerControllerBase::SetSlotContents(const FRPGItemSlot& ItemSlot, const FString& ItemKey)
+{
+	if (InventorySlots.SetItem(ItemSlot, ItemKey))
+	{
+		// Keep the map exposed to blueprints and the inventory interface in sync
+		SlottedItems.FindOrAdd(ItemSlot) = ItemKey;
+
+		if (HasAuthority())
+		{
+			ReplicatedSlots.SetSlot(ItemSlot, ItemKey);
+			InventoryRevision++;
+		}
+	}
+}
+
 void ARPGPlayerControllerBase::NotifyInventoryItemChanged(bool bAdded, FString ItemKey, ERPGItemType ItemType)
 {
+	if (InventoryTransactionDepth > 0)
+	{
+		PendingChangeSet.AddItemChange(bAdded, ItemKey, ItemType);
+		return;
+	}
+
 	// Notify native before blueprint
 	OnInventoryItemChangedNative.Broadcast(bAdded, ItemKey, ItemType);
 	OnInventoryItemChanged.Broadcast(bAdded, ItemKey, ItemType);
@@ -297,6 +736,12 @@ void ARPGPlayerControllerBase::NotifyInventoryItemChanged(bool bAdded, FString I
 
 void ARPGPlayerControllerBase::NotifySlottedItemChanged(FRPGItemSlot ItemSlot, FString ItemKey, ERPGItemType ItemType)
 {
+	if (InventoryTransactionDepth > 0)
+	{
+		PendingChangeSet.AddSlotChange(ItemSlot, ItemKey, ItemType);
+		return;
+	}
+
 	// Notify native before blueprint
 	OnSlottedItemChangedNative.Broadcast(ItemSlot, ItemKey, ItemType);
 	OnSlottedItemChanged.Broadcast(ItemSlot, ItemKey, ItemType);
@@ -305,6 +750,59 @@ void ARPGPlayerControllerBase::NotifySlottedItemChanged(FRPGItemSlot ItemSlot, F
 	SlottedItemChanged(ItemSlot, ItemKey, ItemType);
 }
 
+void ARPGPlayerControllerBase::NotifyInventoryChangeSet()
+{
+	// Move out first so listeners can safely start a new transaction
+	const FRPGInventoryChangeSet ChangeSet = MoveTemp(PendingChangeSet);
+	PendingChangeSet.Reset();
+
+	if (ChangeSet.IsEmpty())
+	{
+		return;
+	}
+
+	// Notify native before blueprint
+	OnInventoryChangeSetNative.Broadcast(ChangeSet);
+	OnInventoryChangeSet.Broadcast(ChangeSet);
+
+	// Call BP update event, the per item events are not replayed so widgets rebuild once per transaction
+	InventoryChangeSetCommitted(ChangeSet);
+}
+
+void ARPGPlayerControllerBase::BeginInventoryTransaction()
+{
+	InventoryTransactionDepth++;
+}
+
+void ARPGPlayerControllerBase::CommitInventoryTransaction()
+{
+	if (InventoryTransactionDepth <= 0)
+	{
+		UE_LOG(LogActionRPG, Warning, TEXT("CommitInventoryTransaction: No transaction is open!"));
+		return;
+	}
+
+	InventoryTransactionDepth--;
+	if (InventoryTransactionDepth == 0)
+	{
+		NotifyInventoryChangeSet();
+	}
+}
+
+bool ARPGPlayerControllerBase::AddInventoryItems(const TMap<FString, FRPGItemData>& NewItems, bool bAutoSlot)
+{
+	bool bChanged = false;
+
+	BeginInventoryTransaction();
+	for (const TPair<FString, FRPGItemData>& Pair : NewItems)
+	{
+		bChanged |= AddInventoryItem(Pair.Key, Pair.Value.ItemType, Pair.Value.ItemCount, Pair.Value.ItemLevel, bAutoSlot);
+	}
+	CommitInventoryTransaction();
+
+	return bChanged;
+}
+
 void ARPGPlayerControllerBase::NotifyInventoryLoaded()
 {
 	// Notify native before blueprint
@@ -314,9 +812,25 @@ void ARPGPlayerControllerBase::NotifyInventoryLoaded()
 
 void ARPGPlayerControllerBase::BeginPlay()
 {
-	InitInventory();
+	if (HasAuthority())
+	{
+		InitInventory();
+	}
+	else if (SlottedItems.Num() == 0)
+	{
+		// Clients only need empty slots, the contents arrive through replication
+		InitInventorySlots();
+	}
 
 	Super::BeginPlay();
 }
 
+void ARPGPlayerControllerBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(ARPGPlayerControllerBase, ReplicatedInventory, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(ARPGPlayerControllerBase, ReplicatedSlots, COND_OwnerOnly);
+}
+
 #pragma optimize("", on)
\ No newline at end of file
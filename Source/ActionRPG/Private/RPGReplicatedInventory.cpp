@@ -0,0 +1,119 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "RPGReplicatedInventory.h"
+#include "RPGPlayerControllerBase.h"
+
+void FRPGInventoryEntry::PreReplicatedRemove(const FRPGInventoryList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnReplicatedItemRemoved(ItemKey);
+	}
+}
+
+void FRPGInventoryEntry::PostReplicatedAdd(const FRPGInventoryList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnReplicatedItemChanged(ItemKey, ItemData);
+	}
+}
+
+void FRPGInventoryEntry::PostReplicatedChange(const FRPGInventoryList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnReplicatedItemChanged(ItemKey, ItemData);
+	}
+}
+
+void FRPGInventoryList::SetItem(const FString& ItemKey, const FRPGItemData& ItemData)
+{
+	if (const int32* FoundIndex = ItemIndices.Find(ItemKey))
+	{
+		FRPGInventoryEntry& Entry = Items[*FoundIndex];
+		if (Entry.ItemData != ItemData)
+		{
+			Entry.ItemData = ItemData;
+			MarkItemDirty(Entry);
+		}
+		return;
+	}
+
+	const int32 NewIndex = Items.Emplace(ItemKey, ItemData);
+	ItemIndices.Add(ItemKey, NewIndex);
+	MarkItemDirty(Items[NewIndex]);
+}
+
+void FRPGInventoryList::RemoveItem(const FString& ItemKey)
+{
+	int32 RemovedIndex = INDEX_NONE;
+	if (!ItemIndices.RemoveAndCopyValue(ItemKey, RemovedIndex))
+	{
+		return;
+	}
+
+	// Order does not matter to clients, so swap the last entry into the hole and fix up its index
+	Items.RemoveAtSwap(RemovedIndex, 1, false);
+	if (Items.IsValidIndex(RemovedIndex))
+	{
+		ItemIndices[Items[RemovedIndex].ItemKey] = RemovedIndex;
+	}
+	MarkArrayDirty();
+}
+
+void FRPGInventoryList::Reset()
+{
+	Items.Reset();
+	ItemIndices.Reset();
+	MarkArrayDirty();
+}
+
+void FRPGSlottedItemEntry::PreReplicatedRemove(const FRPGSlottedItemList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnReplicatedSlotChanged(ItemSlot, FString());
+	}
+}
+
+void FRPGSlottedItemEntry::PostReplicatedAdd(const FRPGSlottedItemList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnReplicatedSlotChanged(ItemSlot, ItemKey);
+	}
+}
+
+void FRPGSlottedItemEntry::PostReplicatedChange(const FRPGSlottedItemList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnReplicatedSlotChanged(ItemSlot, ItemKey);
+	}
+}
+
+void FRPGSlottedItemList::SetSlot(const FRPGItemSlot& ItemSlot, const FString& ItemKey)
+{
+	if (const int32* FoundIndex = SlotIndices.Find(ItemSlot))
+	{
+		FRPGSlottedItemEntry& Entry = Slots[*FoundIndex];
+		if (Entry.ItemKey != ItemKey)
+		{
+			Entry.ItemKey = ItemKey;
+			MarkItemDirty(Entry);
+		}
+		return;
+	}
+
+	const int32 NewIndex = Slots.Emplace(ItemSlot, ItemKey);
+	SlotIndices.Add(ItemSlot, NewIndex);
+	MarkItemDirty(Slots[NewIndex]);
+}
+
+void FRPGSlottedItemList::Reset()
+{
+	Slots.Reset();
+	SlotIndices.Reset();
+	MarkArrayDirty();
+}
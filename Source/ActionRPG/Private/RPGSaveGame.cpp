@@ -0,0 +1,212 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "RPGSaveGame.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace RPGInventorySave
+{
+	/** Identifies an inventory blob, 'RPGI' */
+	static const uint32 Magic = 0x49475052;
+
+	/** Versions of the blob layout, separate from the save game version so the blob can change on its own */
+	enum EBlobVersion : uint32
+	{
+		// Every item wrote its key next to its id
+		InlineKeys = 1,
+		// Items are ids only, keys are in a trailing table for when the catalog changed
+		KeyTable = 2,
+
+		LatestBlobVersion = KeyTable
+	};
+}
+
+void FRPGInventorySaveData::Encode(TArray<uint8>& OutBytes) const
+{
+	OutBytes.Reset();
+	FMemoryWriter Ar(OutBytes);
+
+	uint32 Magic = RPGInventorySave::Magic;
+	uint32 Version = RPGInventorySave::LatestBlobVersion;
+	uint32 Fingerprint = CatalogFingerprint;
+	Ar << Magic;
+	Ar.SerializeIntPacked(Version);
+	Ar << Fingerprint;
+
+	// Counts, levels and catalog indices are small, so packed ints keep most items to four bytes
+	uint32 NumItems = Items.Num();
+	Ar.SerializeIntPacked(NumItems);
+	for (int32 Index = 0; Index < Items.Num(); Index++)
+	{
+		uint8 ItemType = (uint8)Items[Index].ItemType;
+		uint32 CatalogIndex = ItemIds[Index].Index + 1;
+		uint32 ItemCount = FMath::Max(Items[Index].ItemCount, 0);
+		uint32 ItemLevel = FMath::Max(Items[Index].ItemLevel, 0);
+
+		Ar << ItemType;
+		Ar.SerializeIntPacked(CatalogIndex);
+		Ar.SerializeIntPacked(ItemCount);
+		Ar.SerializeIntPacked(ItemLevel);
+	}
+
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		uint32 NumSlots = SlotItems[TypeIndex].Num();
+		Ar.SerializeIntPacked(NumSlots);
+		for (int32 SlotItem : SlotItems[TypeIndex])
+		{
+			uint32 PackedItem = SlotItem + 1;
+			Ar.SerializeIntPacked(PackedItem);
+		}
+	}
+
+	// Key table, prefixed with its size so loads against the same catalog can skip it
+	TArray<uint8> KeyBytes;
+	FMemoryWriter KeyAr(KeyBytes);
+	for (int32 Index = 0; Index < Items.Num(); Index++)
+	{
+		FString ItemKey = ItemKeys[Index];
+		KeyAr << ItemKey;
+	}
+
+	uint32 KeyTableSize = KeyBytes.Num();
+	Ar.SerializeIntPacked(KeyTableSize);
+	Ar.Serialize(KeyBytes.GetData(), KeyBytes.Num());
+}
+
+bool FRPGInventorySaveData::Decode(const TArray<uint8>& Bytes, uint32 CurrentCatalogFingerprint)
+{
+	FMemoryReader Ar(Bytes);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Ar << Magic;
+	Ar.SerializeIntPacked(Version);
+	Ar << CatalogFingerprint;
+	if (Ar.IsError() || Magic != RPGInventorySave::Magic || Version < RPGInventorySave::InlineKeys || Version > RPGInventorySave::LatestBlobVersion)
+	{
+		return false;
+	}
+
+	const bool bInlineKeys = Version == RPGInventorySave::InlineKeys;
+
+	uint32 NumItems = 0;
+	Ar.SerializeIntPacked(NumItems);
+
+	// Every item takes at least four bytes, anything claiming more is corrupt
+	if (Ar.IsError() || NumItems > (uint32)(Ar.TotalSize() - Ar.Tell()) / 4)
+	{
+		return false;
+	}
+
+	ItemKeys.Reset();
+	if (bInlineKeys)
+	{
+		ItemKeys.SetNum(NumItems);
+	}
+	ItemIds.SetNum(NumItems);
+	Items.SetNum(NumItems);
+	for (uint32 Index = 0; Index < NumItems; Index++)
+	{
+		uint8 ItemType = 0;
+		uint32 CatalogIndex = 0;
+		uint32 ItemCount = 0;
+		uint32 ItemLevel = 0;
+
+		if (bInlineKeys)
+		{
+			Ar << ItemKeys[Index];
+		}
+		Ar << ItemType;
+		Ar.SerializeIntPacked(CatalogIndex);
+		Ar.SerializeIntPacked(ItemCount);
+		Ar.SerializeIntPacked(ItemLevel);
+
+		if (Ar.IsError() || ItemType >= (uint8)ERPGItemType::Undefined)
+		{
+			return false;
+		}
+
+		ItemIds[Index] = FRPGItemId((ERPGItemType)ItemType, (int32)CatalogIndex - 1);
+		Items[Index] = FRPGItemData((int32)ItemCount, (int32)ItemLevel, (ERPGItemType)ItemType);
+	}
+
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		uint32 NumSlots = 0;
+		Ar.SerializeIntPacked(NumSlots);
+		if (Ar.IsError() || NumSlots > (uint32)(Ar.TotalSize() - Ar.Tell()))
+		{
+			return false;
+		}
+
+		SlotItems[TypeIndex].SetNum(NumSlots);
+		for (uint32 SlotNumber = 0; SlotNumber < NumSlots; SlotNumber++)
+		{
+			uint32 PackedItem = 0;
+			Ar.SerializeIntPacked(PackedItem);
+			const int32 SlotItem = (int32)PackedItem - 1;
+			SlotItems[TypeIndex][SlotNumber] = Items.IsValidIndex(SlotItem) ? SlotItem : INDEX_NONE;
+		}
+	}
+
+	if (bInlineKeys || Ar.IsError())
+	{
+		return !Ar.IsError();
+	}
+
+	uint32 KeyTableSize = 0;
+	Ar.SerializeIntPacked(KeyTableSize);
+	if (Ar.IsError() || KeyTableSize > (uint32)(Ar.TotalSize() - Ar.Tell()))
+	{
+		return false;
+	}
+
+	if (CatalogFingerprint == CurrentCatalogFingerprint)
+	{
+		// Ids still point at the same items, the keys are never needed
+		Ar.Seek(Ar.Tell() + KeyTableSize);
+		return !Ar.IsError();
+	}
+
+	ItemKeys.SetNum(NumItems);
+	for (uint32 Index = 0; Index < NumItems; Index++)
+	{
+		Ar << ItemKeys[Index];
+	}
+	return !Ar.IsError();
+}
+
+bool FRPGInventorySaveData::RoundTrips(const TArray<uint8>& Bytes) const
+{
+	// Decode against a different fingerprint so the key table is read as well
+	FRPGInventorySaveData Decoded;
+	if (!Decoded.Decode(Bytes, ~CatalogFingerprint))
+	{
+		return false;
+	}
+
+	if (Decoded.CatalogFingerprint != CatalogFingerprint || Decoded.ItemKeys != ItemKeys || Decoded.ItemIds.Num() != ItemIds.Num() || Decoded.Items.Num() != Items.Num())
+	{
+		return false;
+	}
+
+	for (int32 Index = 0; Index < Items.Num(); Index++)
+	{
+		// Only the index is stored, the type comes from the item. Negative counts and levels are clamped on encode
+		const FRPGItemData& Item = Items[Index];
+		if (Decoded.ItemIds[Index].Index != ItemIds[Index].Index || Decoded.Items[Index] != FRPGItemData(FMath::Max(Item.ItemCount, 0), FMath::Max(Item.ItemLevel, 0), Item.ItemType))
+		{
+			return false;
+		}
+	}
+
+	for (int32 TypeIndex = 0; TypeIndex < (int32)ERPGItemType::Undefined; TypeIndex++)
+	{
+		if (Decoded.SlotItems[TypeIndex] != SlotItems[TypeIndex])
+		{
+			return false;
+		}
+	}
+	return true;
+}
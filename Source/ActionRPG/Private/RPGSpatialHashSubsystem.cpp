@@ -0,0 +1,193 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "RPGSpatialHashSubsystem.h"
+#include "RPGCharacterBase.h"
+#include "Components/CapsuleComponent.h"
+
+namespace RPGSpatialHash
+{
+	/** Returns true if a sphere at Point overlaps the cylinder of an entry */
+	template<typename EntryType>
+	static bool OverlapsEntry(const EntryType& Entry, const FVector& Point, float Radius)
+	{
+		const float HorizontalReach = Radius + Entry.Radius;
+		return FVector::DistSquared2D(Entry.Location, Point) <= FMath::Square(HorizontalReach)
+			&& FMath::Abs(Entry.Location.Z - Point.Z) <= Entry.HalfHeight + Radius;
+	}
+}
+
+URPGSpatialHashSubsystem::URPGSpatialHashSubsystem()
+	: CellSize(500.f)
+	, MaxEntryRadius(0.f)
+	, BuiltFrame(MAX_uint64)
+{
+}
+
+URPGSpatialHashSubsystem* URPGSpatialHashSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<URPGSpatialHashSubsystem>() : nullptr;
+}
+
+void URPGSpatialHashSubsystem::RegisterCharacter(ARPGCharacterBase* Character)
+{
+	if (Character)
+	{
+		RegisteredCharacters.AddUnique(Character);
+		BuiltFrame = MAX_uint64;
+	}
+}
+
+void URPGSpatialHashSubsystem::UnregisterCharacter(ARPGCharacterBase* Character)
+{
+	if (RegisteredCharacters.RemoveSwap(Character) > 0)
+	{
+		// The grid holds raw pointers, so it can't wait for the next frame
+		BuiltFrame = MAX_uint64;
+		Entries.Reset();
+		Cells.Reset();
+	}
+}
+
+uint64 URPGSpatialHashSubsystem::GetCellKey(int32 CellX, int32 CellY) const
+{
+	return ((uint64)(uint32)CellX << 32) | (uint64)(uint32)CellY;
+}
+
+void URPGSpatialHashSubsystem::UpdateGrid()
+{
+	if (BuiltFrame == GFrameCounter)
+	{
+		return;
+	}
+	BuiltFrame = GFrameCounter;
+
+	Entries.Reset(RegisteredCharacters.Num());
+	Cells.Reset();
+	MaxEntryRadius = 0.f;
+
+	for (ARPGCharacterBase* Character : RegisteredCharacters)
+	{
+		if (!Character || Character->IsPendingKill() || Character->GetHealth() <= 0.f)
+		{
+			continue;
+		}
+
+		FEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Character = Character;
+		Entry.Location = Character->GetActorLocation();
+		Character->GetCapsuleComponent()->GetScaledCapsuleSize(Entry.Radius, Entry.HalfHeight);
+		Entry.CellKey = GetCellKey(FMath::FloorToInt(Entry.Location.X / CellSize), FMath::FloorToInt(Entry.Location.Y / CellSize));
+		MaxEntryRadius = FMath::Max(MaxEntryRadius, Entry.Radius);
+	}
+
+	Entries.Sort([](const FEntry& A, const FEntry& B) { return A.CellKey < B.CellKey; });
+
+	for (int32 Index = 0; Index < Entries.Num(); Index++)
+	{
+		TPair<int32, int32>* Cell = Cells.Find(Entries[Index].CellKey);
+		if (Cell)
+		{
+			Cell->Value++;
+		}
+		else
+		{
+			Cells.Add(Entries[Index].CellKey, TPair<int32, int32>(Index, 1));
+		}
+	}
+}
+
+template<typename VisitorType>
+void URPGSpatialHashSubsystem::ForEachCandidate(const FVector& Center, float Extent, VisitorType Visitor) const
+{
+	const float Reach = Extent + MaxEntryRadius;
+	const int32 MinX = FMath::FloorToInt((Center.X - Reach) / CellSize);
+	const int32 MaxX = FMath::FloorToInt((Center.X + Reach) / CellSize);
+	const int32 MinY = FMath::FloorToInt((Center.Y - Reach) / CellSize);
+	const int32 MaxY = FMath::FloorToInt((Center.Y + Reach) / CellSize);
+
+	for (int32 CellX = MinX; CellX <= MaxX; CellX++)
+	{
+		for (int32 CellY = MinY; CellY <= MaxY; CellY++)
+		{
+			if (const TPair<int32, int32>* Cell = Cells.Find(GetCellKey(CellX, CellY)))
+			{
+				for (int32 Index = Cell->Key; Index < Cell->Key + Cell->Value; Index++)
+				{
+					Visitor(Entries[Index]);
+				}
+			}
+		}
+	}
+}
+
+void URPGSpatialHashSubsystem::QuerySphere(const FVector& Center, float Radius, TArray<ARPGCharacterBase*>& OutCharacters)
+{
+	UpdateGrid();
+
+	ForEachCandidate(Center, Radius, [&](const FEntry& Entry)
+	{
+		if (RPGSpatialHash::OverlapsEntry(Entry, Center, Radius))
+		{
+			OutCharacters.Add(Entry.Character);
+		}
+	});
+}
+
+void URPGSpatialHashSubsystem::QueryCone(const FVector& Origin, const FVector& Direction, float Length, float HalfAngle, TArray<ARPGCharacterBase*>& OutCharacters)
+{
+	UpdateGrid();
+
+	const FVector Forward = Direction.GetSafeNormal2D();
+	const float HalfAngleRadians = FMath::DegreesToRadians(FMath::Clamp(HalfAngle, 0.f, 180.f));
+
+	ForEachCandidate(Origin, Length, [&](const FEntry& Entry)
+	{
+		if (!RPGSpatialHash::OverlapsEntry(Entry, Origin, Length))
+		{
+			return;
+		}
+
+		const FVector ToEntry = (Entry.Location - Origin) * FVector(1.f, 1.f, 0.f);
+		const float Distance = ToEntry.Size();
+		if (Distance <= Entry.Radius)
+		{
+			// Standing on the origin counts as inside
+			OutCharacters.Add(Entry.Character);
+			return;
+		}
+
+		// Widen the cone by the angle the character's radius covers at that distance
+		const float Angle = FMath::Acos(FMath::Clamp(FVector::DotProduct(ToEntry / Distance, Forward), -1.f, 1.f));
+		if (Angle <= HalfAngleRadians + FMath::Asin(Entry.Radius / Distance))
+		{
+			OutCharacters.Add(Entry.Character);
+		}
+	});
+}
+
+void URPGSpatialHashSubsystem::QueryCapsule(const FVector& Start, const FVector& End, float Radius, TArray<ARPGCharacterBase*>& OutCharacters)
+{
+	UpdateGrid();
+
+	const FVector Center = (Start + End) * 0.5f;
+	const float Extent = FVector::Dist2D(Start, End) * 0.5f + Radius;
+
+	ForEachCandidate(Center, Extent, [&](const FEntry& Entry)
+	{
+		const FVector ClosestPoint = FMath::ClosestPointOnSegment(Entry.Location, Start, End);
+		if (RPGSpatialHash::OverlapsEntry(Entry, ClosestPoint, Radius))
+		{
+			OutCharacters.Add(Entry.Character);
+		}
+	});
+}
+
+void URPGSpatialHashSubsystem::Deinitialize()
+{
+	RegisteredCharacters.Reset();
+	Entries.Reset();
+	Cells.Reset();
+
+	Super::Deinitialize();
+}
@@ -0,0 +1,155 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "RPGWeaponPoolSubsystem.h"
+#include "RPGGameInstanceBase.h"
+#include "RPGPoolableInterface.h"
+#include "Items/RPGWeaponItem.h"
+#include "Engine/World.h"
+
+URPGWeaponPoolSubsystem* URPGWeaponPoolSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<URPGWeaponPoolSubsystem>() : nullptr;
+}
+
+AActor* URPGWeaponPoolSubsystem::SpawnWeapon(UClass* WeaponClass, const FTransform& SpawnTransform, AActor* WeaponOwner)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Owner = WeaponOwner;
+	SpawnParameters.Instigator = Cast<APawn>(WeaponOwner);
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AActor>(WeaponClass, SpawnTransform, SpawnParameters);
+}
+
+AActor* URPGWeaponPoolSubsystem::AcquireWeapon(TSubclassOf<AActor> WeaponClass, const FTransform& SpawnTransform, AActor* WeaponOwner)
+{
+	if (!WeaponClass)
+	{
+		return nullptr;
+	}
+
+	FRPGPooledActorList* FreeList = FreeWeapons.Find(WeaponClass);
+	while (FreeList && FreeList->Actors.Num() > 0)
+	{
+		AActor* Weapon = FreeList->Actors.Pop(false);
+
+		// Pooled actors can still be destroyed by a level unload
+		if (!Weapon || Weapon->IsPendingKill())
+		{
+			continue;
+		}
+
+		Weapon->SetOwner(WeaponOwner);
+		Weapon->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+		Weapon->SetActorHiddenInGame(false);
+		Weapon->SetActorEnableCollision(true);
+		Weapon->SetActorTickEnabled(Weapon->PrimaryActorTick.bStartWithTickEnabled);
+
+		if (Weapon->GetClass()->ImplementsInterface(URPGPoolableInterface::StaticClass()))
+		{
+			IRPGPoolableInterface::Execute_OnAcquiredFromPool(Weapon);
+		}
+		return Weapon;
+	}
+
+	return SpawnWeapon(WeaponClass, SpawnTransform, WeaponOwner);
+}
+
+void URPGWeaponPoolSubsystem::ReleaseWeapon(AActor* Weapon)
+{
+	if (!Weapon || Weapon->IsPendingKill())
+	{
+		return;
+	}
+
+	if (Weapon->GetClass()->ImplementsInterface(URPGPoolableInterface::StaticClass()))
+	{
+		IRPGPoolableInterface::Execute_OnReturnedToPool(Weapon);
+	}
+
+	Weapon->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	Weapon->SetActorHiddenInGame(true);
+	Weapon->SetActorEnableCollision(false);
+	Weapon->SetActorTickEnabled(false);
+	Weapon->SetOwner(nullptr);
+
+	FreeWeapons.FindOrAdd(Weapon->GetClass()).Actors.AddUnique(Weapon);
+}
+
+void URPGWeaponPoolSubsystem::PrewarmWeapon(TSubclassOf<AActor> WeaponClass, int32 Count)
+{
+	if (!WeaponClass)
+	{
+		return;
+	}
+
+	const int32 NumFree = FreeWeapons.FindOrAdd(WeaponClass).Actors.Num();
+	for (int32 Index = NumFree; Index < Count; Index++)
+	{
+		if (AActor* Weapon = SpawnWeapon(WeaponClass, FTransform::Identity, nullptr))
+		{
+			ReleaseWeapon(Weapon);
+		}
+	}
+}
+
+void URPGWeaponPoolSubsystem::PrewarmFromCatalog()
+{
+	UWorld* World = GetWorld();
+	URPGGameInstanceBase* GameInstance = World ? World->GetGameInstance<URPGGameInstanceBase>() : nullptr;
+	if (!GameInstance)
+	{
+		return;
+	}
+
+	const FRPGItemCatalog& Catalog = GameInstance->GetItemCatalog();
+	TArray<FRPGItemId> UnloadedWeapons;
+	for (int32 Index = 0; Index < Catalog.Num(ERPGItemType::Weapon); Index++)
+	{
+		const FRPGWeaponItemStruct* Weapon = Catalog.GetWeapon(Index);
+		if (Weapon && Weapon->PoolPrewarmCount > 0 && !Weapon->WeaponActor)
+		{
+			UnloadedWeapons.Add(FRPGItemId(ERPGItemType::Weapon, Index));
+		}
+	}
+
+	PrewarmLoadedCatalogWeapons();
+
+	if (UnloadedWeapons.Num() > 0)
+	{
+		GameInstance->RequestItemAssets(UnloadedWeapons, FStreamableDelegate::CreateUObject(this, &URPGWeaponPoolSubsystem::PrewarmLoadedCatalogWeapons));
+	}
+}
+
+void URPGWeaponPoolSubsystem::PrewarmLoadedCatalogWeapons()
+{
+	UWorld* World = GetWorld();
+	URPGGameInstanceBase* GameInstance = World ? World->GetGameInstance<URPGGameInstanceBase>() : nullptr;
+	if (!GameInstance)
+	{
+		return;
+	}
+
+	const FRPGItemCatalog& Catalog = GameInstance->GetItemCatalog();
+	for (int32 Index = 0; Index < Catalog.Num(ERPGItemType::Weapon); Index++)
+	{
+		const FRPGWeaponItemStruct* Weapon = Catalog.GetWeapon(Index);
+		if (Weapon && Weapon->PoolPrewarmCount > 0 && Weapon->WeaponActor)
+		{
+			PrewarmWeapon(Weapon->WeaponActor, Weapon->PoolPrewarmCount);
+		}
+	}
+}
+
+void URPGWeaponPoolSubsystem::Deinitialize()
+{
+	FreeWeapons.Reset();
+
+	Super::Deinitialize();
+}
@@ -0,0 +1,75 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "GameplayAbilitySpec.h"
+#include "GameplayEffectTypes.h"
+#include "UObject/ObjectKey.h"
+
+class UAbilitySystemComponent;
+class UGameplayEffect;
+class URPGGameplayAbility;
+
+/** Handles of what a loadout gave to one ability system, so it can be re-leveled or removed without searching */
+struct ACTIONRPG_API FRPGGrantedAbilityLoadout
+{
+	TArray<FGameplayAbilitySpecHandle> AbilityHandles;
+	TArray<FActiveGameplayEffectHandle> EffectHandles;
+
+	/** Forgets the effect handles, for when the effects were removed some other way */
+	void ResetEffects() { EffectHandles.Reset(); }
+};
+
+/**
+ * The startup abilities and passive effects of a character class, filtered and sorted once and then given to any number of ability systems
+ * Passives are split by duration policy up front, duration and infinite ones are re-leveled in place and instant ones are applied again
+ * Only classes are stored, effect defaults are looked up when applied. Game thread only
+ */
+class ACTIONRPG_API FRPGAbilityLoadout
+{
+public:
+	/**
+	 * Returns the loadout for a class, built on first use and rebuilt if the arrays passed in no longer match it,
+	 * which happens when a blueprint is edited or a placed instance overrides the class defaults
+	 * The arrays are matched by object identity, so a class that was unloaded or reinstanced never matches a new one at the same address.
+	 * A rebuild replaces the loadout instead of changing it, so a returned loadout stays valid while held, but should not be kept past the frame
+	 */
+	static TSharedRef<const FRPGAbilityLoadout> Get(const UClass* OwnerClass, const TArray<TSubclassOf<URPGGameplayAbility>>& Abilities, const TArray<TSubclassOf<UGameplayEffect>>& PassiveEffects);
+
+	/** Gives every ability at the level, recording the handles */
+	void GiveAbilities(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject, int32 Level, FRPGGrantedAbilityLoadout& OutGranted) const;
+
+	/** Applies every passive effect at the level with one shared context, recording the handles of effects that stay active */
+	void ApplyPassiveEffects(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject, int32 Level, FRPGGrantedAbilityLoadout& OutGranted) const;
+
+	/** Changes the level of the given abilities in place */
+	void SetAbilityLevel(UAbilitySystemComponent* AbilitySystem, int32 Level, const FRPGGrantedAbilityLoadout& Granted) const;
+
+	/** Changes the level of the active passive effects in place and applies the instant ones again at the new level */
+	void SetPassiveEffectLevel(UAbilitySystemComponent* AbilitySystem, UObject* SourceObject, int32 Level, FRPGGrantedAbilityLoadout& Granted) const;
+
+	/** Clears the given abilities. Effects are left to the caller, which usually removes every effect it was the source of */
+	static void ClearAbilities(UAbilitySystemComponent* AbilitySystem, FRPGGrantedAbilityLoadout& Granted);
+
+private:
+	void Build(const TArray<TSubclassOf<URPGGameplayAbility>>& Abilities, const TArray<TSubclassOf<UGameplayEffect>>& PassiveEffects);
+
+	/** Returns true if the arrays are the ones the loadout was built from */
+	bool MatchesSource(const TArray<TSubclassOf<URPGGameplayAbility>>& Abilities, const TArray<TSubclassOf<UGameplayEffect>>& PassiveEffects) const;
+
+	/** The arrays the loadout was built from, compared on every Get */
+	TArray<FObjectKey> SourceAbilities;
+	TArray<FObjectKey> SourcePassiveEffects;
+
+	/** Non null abilities, each class once */
+	TArray<TSubclassOf<URPGGameplayAbility>> AbilityClasses;
+
+	/** Passive effects that have a duration */
+	TArray<TSubclassOf<UGameplayEffect>> PersistentEffects;
+
+	/** Instant passive effects, these have no handle and are applied again on a level change */
+	TArray<TSubclassOf<UGameplayEffect>> InstantEffects;
+
+	static TMap<FObjectKey, TSharedRef<const FRPGAbilityLoadout>>& GetLoadouts();
+};
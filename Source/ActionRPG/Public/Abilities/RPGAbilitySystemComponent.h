@@ -5,9 +5,11 @@
 #include "ActionRPG.h"
 #include "AbilitySystemComponent.h"
 #include "Abilities/RPGAbilityTypes.h"
+#include "Abilities/RPGGameplayAbility.h"
 #include "RPGAbilitySystemComponent.generated.h"
 
-class URPGGameplayAbility;
+/** Called for gameplay events matching a listener, the payload is passed on by reference */
+DECLARE_DELEGATE_TwoParams(FRPGGameplayEventDelegate, FGameplayTag, const FGameplayEventData&);
 
 /**
  * Subclass of ability system component with game-specific data
@@ -25,10 +27,186 @@ public:
 	/** Returns a list of currently active ability instances that match the tags */
 	void GetActiveAbilitiesWithTags(const FGameplayTagContainer& GameplayTagContainer, TArray<URPGGameplayAbility*>& ActiveAbilities);
 
+	/** Same as above for arrays with another allocator, so callers can collect into a TInlineAllocator array on the stack */
+	template<typename AllocatorType>
+	void GetActiveAbilitiesWithTags(const FGameplayTagContainer& GameplayTagContainer, TArray<URPGGameplayAbility*, AllocatorType>& ActiveAbilities)
+	{
+		ForEachAbilityInstanceWithTags(GameplayTagContainer, [&ActiveAbilities](URPGGameplayAbility* AbilityInstance)
+		{
+			ActiveAbilities.Add(AbilityInstance);
+			return true;
+		});
+	}
+
+	/**
+	 * Calls Func with every ability spec whose ability has all of the tags, without allocating. Func returns false to stop
+	 * Func must not give or remove abilities
+	 */
+	template<typename FuncType>
+	void ForEachAbilitySpecWithTags(const FGameplayTagContainer& GameplayTagContainer, FuncType Func)
+	{
+		const FGameplayAbilitySpecHandle* Handles = nullptr;
+		int32 NumHandles = 0;
+		GetAbilityHandlesWithTags(GameplayTagContainer, Handles, NumHandles);
+
+		for (int32 Index = 0; Index < NumHandles; Index++)
+		{
+			FGameplayAbilitySpec* Spec = FindAbilitySpecFromHandle(Handles[Index]);
+			if (Spec && Spec->Ability && Spec->Ability->AbilityTags.HasAll(GameplayTagContainer) && !Func(*Spec))
+			{
+				return;
+			}
+		}
+	}
+
+	/**
+	 * Calls Func with every instance of the abilities that have all of the tags, without copying the instance lists. Func returns false to stop
+	 * Func must not end abilities, collect them with GetActiveAbilitiesWithTags first to cancel them
+	 */
+	template<typename FuncType>
+	void ForEachAbilityInstanceWithTags(const FGameplayTagContainer& GameplayTagContainer, FuncType Func)
+	{
+		ForEachAbilitySpecWithTags(GameplayTagContainer, [&Func](FGameplayAbilitySpec& Spec)
+		{
+			return ForEachAbilityInstance(Spec, Func);
+		});
+	}
+
+	/** Calls Func with every instance of one ability spec, returns false if Func stopped it */
+	template<typename FuncType>
+	static bool ForEachAbilityInstance(const FGameplayAbilitySpec& Spec, FuncType&& Func)
+	{
+		for (UGameplayAbility* AbilityInstance : Spec.ReplicatedInstances)
+		{
+			URPGGameplayAbility* RPGAbility = Cast<URPGGameplayAbility>(AbilityInstance);
+			if (RPGAbility && !Func(RPGAbility))
+			{
+				return false;
+			}
+		}
+		for (UGameplayAbility* AbilityInstance : Spec.NonReplicatedInstances)
+		{
+			URPGGameplayAbility* RPGAbility = Cast<URPGGameplayAbility>(AbilityInstance);
+			if (RPGAbility && !Func(RPGAbility))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Returns true if any ability that has all of the tags is running. A single tag is answered from a count kept as abilities start and end */
+	bool IsAnyAbilityActiveWithTags(const FGameplayTagContainer& GameplayTagContainer);
+
+	/**
+	 * Lighter version of AddGameplayEventTagContainerDelegate, events are matched with a tag mask compiled once per OwnerClass
+	 * and the payload is not copied. An empty filter receives every event
+	 */
+	FDelegateHandle AddGameplayEventListener(const FGameplayTagContainer& FilterTags, const UClass* OwnerClass, FRPGGameplayEventDelegate Delegate);
+
+	/** Removes a listener added with AddGameplayEventListener, safe to call while events are dispatched */
+	void RemoveGameplayEventListener(FDelegateHandle Handle);
+
+	virtual int32 HandleGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload) override;
+
+	virtual void NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability) override;
+	virtual void NotifyAbilityEnded(FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, bool bWasCancelled) override;
+
+	/**
+	 * Same as TryActivateAbilitiesByTag, but finds the abilities through an index of ability tags instead of checking every ability
+	 * The index is rebuilt on the first call after an ability is given or removed
+	 */
+	bool TryActivateAbilitiesByTagIndexed(const FGameplayTagContainer& GameplayTagContainer, bool bAllowRemoteActivation = true);
+
 	/** Returns the default level used for ability activations, derived from the character */
 	int32 GetDefaultAbilityLevel() const;
 
 	/** Version of function in AbilitySystemGlobals that returns correct type */
 	static URPGAbilitySystemComponent* GetAbilitySystemComponentFromActor(const AActor* Actor, bool LookForComponent = false);
 
+	/**
+	 * Returns the remaining and total time of the longest running cooldown matching any of the tags, false if none are active
+	 * Results for tags under Cooldown are cached and only recomputed after a cooldown tag is added or removed, so polling every frame is cheap.
+	 * Any other tag is queried directly every call
+	 */
+	bool GetCooldownRemainingForTags(const FGameplayTagContainer& CooldownTags, float& TimeRemaining, float& CooldownDuration);
+
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+protected:
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+
+	/** Rebuilds AbilityTagIndex if abilities changed since it was built */
+	void UpdateAbilityTagIndex();
+
+	/** Returns the smallest list of handles that contains every ability with all of the tags, the list can have abilities that don't match */
+	void GetAbilityHandlesWithTags(const FGameplayTagContainer& GameplayTagContainer, const FGameplayAbilitySpecHandle*& OutHandles, int32& OutNumHandles);
+
+	/** One listener added with AddGameplayEventListener */
+	struct FGameplayEventListener
+	{
+		FGameplayTagContainer FilterTags;
+		uint64 FilterMask;
+		bool bExactMask;
+		FRPGGameplayEventDelegate Delegate;
+	};
+
+	/** Calls every listener matching the event */
+	void DispatchGameplayEventToListeners(FGameplayTag EventTag, const FGameplayEventData& Payload);
+
+	/** Listeners in the order they were added, removed ones are unbound and compacted after dispatch */
+	TArray<FGameplayEventListener> GameplayEventListeners;
+
+	/** Listeners added during a dispatch, so the array being dispatched never reallocates */
+	TArray<FGameplayEventListener> PendingGameplayEventListeners;
+
+	/** Greater than zero while events are being dispatched to listeners */
+	int32 GameplayEventDispatchDepth;
+
+	/** Number of running abilities with each ability tag and its parents */
+	TMap<FGameplayTag, int32> ActiveAbilityTagCounts;
+
+	/** Handles of every ability by each of its ability tags and their parents, so a tag finds its abilities without a scan */
+	TMap<FGameplayTag, TArray<FGameplayAbilitySpecHandle, TInlineAllocator<4>>> AbilityTagIndex;
+
+	/** Handles of every ability, for activating with an empty tag container */
+	TArray<FGameplayAbilitySpecHandle> AllAbilityHandles;
+
+	/** Set when an ability is given or removed */
+	bool bAbilityTagIndexDirty;
+
+	/** Cached cooldown for a single tag, valid while Generation matches CooldownGeneration */
+	struct FCachedCooldown
+	{
+		float EndTime = 0.f;
+		float Duration = 0.f;
+		uint32 Generation = 0;
+	};
+
+	/** Invalidates every cached cooldown */
+	void InvalidateCooldownCache()
+	{
+		CooldownGeneration++;
+	}
+
+	/** Bound to tag and effect events that can change a cooldown */
+	void OnCooldownTagChanged(const FGameplayTag Tag, int32 NewCount);
+	void OnCooldownEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& SpecApplied, FActiveGameplayEffectHandle ActiveHandle);
+	void OnCooldownEffectRemoved(const FActiveGameplayEffect& RemovedEffect);
+
+	/** Cached cooldowns by tag */
+	TMap<FGameplayTag, FCachedCooldown> CooldownCache;
+
+	/** Bumped whenever something that could change a cooldown happens, starts at 1 so zeroed entries are never valid */
+	uint32 CooldownGeneration;
+
+	/** Parent of all cooldown tags */
+	FGameplayTag CooldownRootTag;
+
+	/** Delegate handles */
+	FDelegateHandle CooldownTagChangedHandle;
+	FDelegateHandle CooldownEffectAddedHandle;
+	FDelegateHandle CooldownEffectRemovedHandle;
 };
\ No newline at end of file
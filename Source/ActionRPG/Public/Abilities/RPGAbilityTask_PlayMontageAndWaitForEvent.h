@@ -74,6 +74,9 @@ public:
 		bool bStopWhenAbilityEnds = true,
 		float AnimRootMotionTranslationScale = 1.f);
 
+	/** Unbinds the callbacks a pooled task keeps between uses and lets it be garbage collected, called when its ability is removed */
+	void ReleaseFromPool();
+
 private:
 	/** Montage that is playing */
 	UPROPERTY()
@@ -105,13 +108,38 @@ private:
 	/** Returns our ability system component */
 	URPGAbilitySystemComponent* GetTargetASC();
 
-	void OnMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted);
+	/** Prepares a pooled task for another use by the ability, like NewAbilityTask does for a new one */
+	void ResetForReuse(UGameplayAbility& OwningAbility, FName TaskInstanceName);
+
+	/** Registers for gameplay events matching EventTags, keeping an existing registration for the same tags */
+	void BindEventCallback(URPGAbilitySystemComponent* RPGAbilitySystemComponent);
+
+	/** Removes the gameplay event registration */
+	void UnbindEventCallback(URPGAbilitySystemComponent* RPGAbilitySystemComponent);
+
+	/** Unbinds this task from every montage instance still calling it, needed before a pooled task is reused */
+	void UnbindMontageDelegates();
+
+	void OnMontageBlendingOut(UAnimMontage* Montage, bool bInterrupted, uint32 Serial);
 	void OnAbilityCancelled();
-	void OnMontageEnded(UAnimMontage* Montage, bool bInterrupted);
+	void OnMontageEnded(UAnimMontage* Montage, bool bInterrupted, uint32 Serial);
 	void OnGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload);
+	void OnGameplayEventListener(FGameplayTag EventTag, const FGameplayEventData& Payload);
 
 	FOnMontageBlendingOutStarted BlendingOutDelegate;
 	FOnMontageEnded MontageEndedDelegate;
 	FDelegateHandle CancelledHandle;
 	FDelegateHandle EventHandle;
+
+	/** True if EventHandle is from AddGameplayEventListener rather than AddGameplayEventTagContainerDelegate */
+	bool bUsingEventListener;
+
+	/** Tags EventHandle was registered with */
+	FGameplayTagContainer RegisteredEventTags;
+
+	/** True if this task goes back to its ability when it ends instead of being destroyed */
+	bool bPooled;
+
+	/** Incremented each time the task plays its montage, the montage delegates only act on the current value */
+	uint32 ActivationSerial;
 };
@@ -18,6 +18,80 @@ class UGameplayEffect;
 class URPGTargetType;
 
 
+/** Cooldown state of the ability granted by an inventory slot, used for HUD polling */
+USTRUCT(BlueprintType)
+struct FRPGSlottedAbilityCooldown
+{
+	GENERATED_BODY()
+
+public:
+	FRPGSlottedAbilityCooldown()
+		: TimeRemaining(0.f)
+		, CooldownDuration(0.f)
+		, bOnCooldown(false)
+	{}
+
+	/** Slot that granted the ability */
+	UPROPERTY(BlueprintReadOnly, Category = Cooldown)
+	FRPGItemSlot ItemSlot;
+
+	/** Seconds left on the cooldown, 0 if not on cooldown */
+	UPROPERTY(BlueprintReadOnly, Category = Cooldown)
+	float TimeRemaining;
+
+	/** Total length of the active cooldown, 0 if not on cooldown */
+	UPROPERTY(BlueprintReadOnly, Category = Cooldown)
+	float CooldownDuration;
+
+	/** True if the ability is on cooldown */
+	UPROPERTY(BlueprintReadOnly, Category = Cooldown)
+	bool bOnCooldown;
+};
+
+/**
+ * Target data holding every hit of a sweep in one contiguous array, instead of one heap allocated single hit per result
+ * Applying an effect through it applies to each hit actor with that hit in the effect context, same as a list of single hits would
+ * Allocate() hands out pooled instances that return to the pool when the last handle releases them
+ */
+USTRUCT(BlueprintType)
+struct ACTIONRPG_API FRPGGameplayAbilityTargetData_MultiHit : public FGameplayAbilityTargetData
+{
+	GENERATED_BODY()
+
+public:
+	FRPGGameplayAbilityTargetData_MultiHit() {}
+
+	/** The hits, in the order they were added */
+	UPROPERTY()
+	TArray<FHitResult> HitResults;
+
+	/** Returns an empty instance from the pool, wrapped so it goes back to the pool instead of being deleted */
+	static TSharedPtr<FRPGGameplayAbilityTargetData_MultiHit> Allocate();
+
+	// FGameplayAbilityTargetData interface
+	virtual TArray<TWeakObjectPtr<AActor>> GetActors() const override;
+	virtual bool HasHitResult() const override;
+	virtual const FHitResult* GetHitResult() const override;
+	virtual TArray<FActiveGameplayEffectHandle> ApplyGameplayEffectSpec(FGameplayEffectSpec& Spec, FPredictionKey PredictionKey = FPredictionKey()) override;
+	virtual UScriptStruct* GetScriptStruct() const override;
+	virtual FString ToString() const override;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+private:
+	/** Deleter used by Allocate */
+	static void ReturnToPool(FRPGGameplayAbilityTargetData_MultiHit* TargetData);
+};
+
+template<>
+struct TStructOpsTypeTraits<FRPGGameplayAbilityTargetData_MultiHit> : public TStructOpsTypeTraitsBase2<FRPGGameplayAbilityTargetData_MultiHit>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
 /**
  * Struct defining a list of gameplay effects, a tag, and targeting info
  * These containers are defined statically in blueprints or assets and then turn into Specs at runtime
@@ -48,7 +122,10 @@ struct FRPGGameplayEffectContainerSpec
 public:
 	FRPGGameplayEffectContainerSpec() {}
 
-	/** Computed target data */
+	/**
+	 * Computed target data. All hit results of one AddTargets call are a single multi hit entry,
+	 * so the data count is 1 for any number of hits and reading the hit result at index 0 returns only the first hit. Use the actors to get every target
+	 */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = GameplayEffectContainer)
 	FGameplayAbilityTargetDataHandle TargetData;
 
@@ -62,6 +139,12 @@ public:
 	/** Returns true if this has any valid targets */
 	bool HasValidTargets() const;
 
-	/** Adds new targets to target data */
+	/**
+	 * Adds new targets to target data, all hit results go into one multi hit entry and all actors into one actor array entry
+	 * This adds at most two entries regardless of the number of hits, unlike one entry per hit before. Applying effects still reaches every hit
+	 */
 	void AddTargets(const TArray<FHitResult>& HitResults, const TArray<AActor*>& TargetActors);
+
+	/** Same as above, but moves the hit results instead of copying them */
+	void AddTargets(TArray<FHitResult>&& HitResults, const TArray<AActor*>& TargetActors);
 };
@@ -6,6 +6,11 @@
 #include "GameplayEffectExecutionCalculation.h"
 #include "RPGDamageExecution.generated.h"
 
+class UAbilitySystemComponent;
+class UGameplayEffect;
+struct FGameplayEffectSpec;
+struct FGameplayAbilityTargetDataHandle;
+
 /**
  * A damage execution, which allows doing damage by combining a raw Damage number with AttackPower and DefensePower
  * Most games will want to implement multiple game-specific executions
@@ -20,4 +25,45 @@ public:
 	URPGDamageExecution();
 	virtual void Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, OUT FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const override;
 
-};
\ No newline at end of file
+};
+
+/**
+ * Computes the damage of one effect spec for many targets at once, opened around applying the spec to its targets
+ * The source AttackPower and Damage are evaluated once, target DefensePower is read from every target into one array,
+ * and all results come out of a single pass. URPGDamageExecution uses the result for its target while this is in scope
+ * Source modifiers that depend on target tags and target modifiers that depend on source tags are only evaluated once, so this is opt-in
+ */
+struct ACTIONRPG_API FRPGScopedDamageBatch
+{
+	FRPGScopedDamageBatch(const FGameplayEffectSpec& Spec, const FGameplayAbilityTargetDataHandle& TargetData);
+	~FRPGScopedDamageBatch();
+
+	/** Returns the innermost batch in scope, or null */
+	static FRPGScopedDamageBatch* GetActive();
+
+	/** Returns the damage for the target of an execution, false if the execution is not part of this batch */
+	bool FindDamageDone(const FGameplayEffectCustomExecutionParameters& ExecutionParams, const FAggregatorEvaluateParameters& EvaluationParameters, float& OutDamageDone);
+
+private:
+	FRPGScopedDamageBatch(const FRPGScopedDamageBatch&) = delete;
+	FRPGScopedDamageBatch& operator=(const FRPGScopedDamageBatch&) = delete;
+
+	/** Evaluates the source side and computes damage for every target */
+	void ComputeDamage(const FGameplayEffectCustomExecutionParameters& ExecutionParams, const FAggregatorEvaluateParameters& EvaluationParameters);
+
+	/** Identifies the spec, applying it to a target copies it so it is matched by definition, level and instigator */
+	const UGameplayEffect* EffectDef;
+	float EffectLevel;
+	const UAbilitySystemComponent* InstigatorAbilitySystem;
+
+	/** Ability systems of the targets, each once */
+	TArray<UAbilitySystemComponent*> Targets;
+	TMap<const UAbilitySystemComponent*, int32> TargetIndices;
+
+	/** DefensePower of each target, replaced with the damage done once computed */
+	TArray<float> TargetDamage;
+	bool bComputed;
+
+	FRPGScopedDamageBatch* OuterBatch;
+	static FRPGScopedDamageBatch* ActiveBatch;
+};
@@ -8,6 +8,8 @@
 #include "Abilities/RPGAbilityTypes.h"
 #include "RPGGameplayAbility.generated.h"
 
+class URPGAbilityTask_PlayMontageAndWaitForEvent;
+
 /**
  * Subclass of ability blueprint type with game-specific data
  * This class uses GameplayEffectContainers to allow easier execution of gameplay effects based on a triggering tag
@@ -26,6 +28,21 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = GameplayEffects)
 	TMap<FGameplayTag, FRPGGameplayEffectContainer> EffectContainerMap;
 
+	/** If true, damage for all targets of a container is computed in one batch, see FRPGScopedDamageBatch. Meant for sweeping skills that hit many enemies */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = GameplayEffects)
+	bool bBatchDamageExecution;
+
+	/** If true, montage tasks of this ability receive gameplay events through the listener table on the ability system instead of tag container delegates */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Ability)
+	bool bUseFastEventRouting;
+
+	/**
+	 * If true, PlayMontageAndWaitForEvent tasks of this ability are kept when they end and reused by the next activation
+	 * Only used by abilities instanced per actor, the others don't live long enough to reuse anything
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Ability)
+	bool bPoolMontageTasks;
+
 	/** Make gameplay effect container spec to be applied later, using the passed in container */
 	UFUNCTION(BlueprintCallable, Category = Ability, meta=(AutoCreateRefTerm = "EventData"))
 	virtual FRPGGameplayEffectContainerSpec MakeEffectContainerSpecFromContainer(const FRPGGameplayEffectContainer& Container, const FGameplayEventData& EventData, int32 OverrideGameplayLevel = -1);
@@ -41,4 +58,46 @@ public:
 	/** Applies a gameplay effect container, by creating and then applying the spec */
 	UFUNCTION(BlueprintCallable, Category = Ability, meta = (AutoCreateRefTerm = "EventData"))
 	virtual TArray<FActiveGameplayEffectHandle> ApplyEffectContainer(FGameplayTag ContainerTag, const FGameplayEventData& EventData, int32 OverrideGameplayLevel = -1);
+
+	/** Returns true if montage tasks of this ability should be pooled */
+	bool ShouldPoolMontageTasks() const;
+
+	/** Returns a finished montage task for reuse, or null if there is none */
+	URPGAbilityTask_PlayMontageAndWaitForEvent* TakePooledMontageTask();
+
+	/** Called by a pooled montage task when it ends */
+	void ReturnPooledMontageTask(URPGAbilityTask_PlayMontageAndWaitForEvent* Task);
+
+	virtual void OnRemoveAbility(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
+
+protected:
+	/** Effect specs prepared for one container at one level, reused by MakeEffectContainerSpec */
+	struct FCachedContainerSpec
+	{
+		FGameplayTag ContainerTag;
+		int32 Level;
+		const FRPGGameplayEffectContainer* Container;
+
+		/** Specs as made by MakeOutgoingGameplayEffectSpec, restored before each reuse so changes made by callers don't build up */
+		TArray<FGameplayEffectSpec> Templates;
+
+		/** Handles given out last time, reused if nothing else holds them anymore */
+		TArray<FGameplayEffectSpecHandle> Handles;
+	};
+
+	/** Runs the targeting of a container into the spec, returns false if there is no ability system to make specs with */
+	bool AddContainerTargets(const FRPGGameplayEffectContainer& Container, const FGameplayEventData& EventData, FRPGGameplayEffectContainerSpec& OutSpec);
+
+	/** Finds the prepared specs for a container, making them on first use. Returns null if the container does not exist */
+	FCachedContainerSpec* FindOrAddCachedContainerSpec(FGameplayTag ContainerTag, int32 Level, bool& bOutAdded);
+
+	/** Brings a reused spec up to date with the current activation */
+	void RefreshCachedSpec(FGameplayEffectSpec& Spec) const;
+
+	/** Prepared specs, only used by abilities instanced per actor as the others don't keep state between activations */
+	TArray<FCachedContainerSpec> CachedContainerSpecs;
+
+	/** Finished montage tasks waiting to be reused */
+	UPROPERTY(Transient)
+	TArray<URPGAbilityTask_PlayMontageAndWaitForEvent*> PooledMontageTasks;
 };
\ No newline at end of file
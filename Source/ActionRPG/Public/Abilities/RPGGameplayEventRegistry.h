@@ -0,0 +1,43 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
+
+/**
+ * Gives each gameplay event tag that something listens for one bit, so matching an event against a listener is a mask test
+ * Listener filters are compiled once per ability class, and the mask of each event tag is cached until a new tag gets a bit
+ * Only the first 64 tags get a bit, filters using any other tag fall back to normal tag matching
+ * Game thread only
+ */
+class ACTIONRPG_API FRPGGameplayEventTagRegistry
+{
+public:
+	static FRPGGameplayEventTagRegistry& Get();
+
+	/** Returns the mask of a listener filter, bOutExact is false if a tag had no bit and the filter needs tag matching */
+	uint64 CompileFilter(const UClass* OwnerClass, const FGameplayTagContainer& FilterTags, bool& bOutExact);
+
+	/** Returns the bits of every tag an event with EventTag matches, which are the tag itself and its parents */
+	uint64 GetEventMask(const FGameplayTag& EventTag);
+
+private:
+	/** A filter as compiled for one class */
+	struct FCompiledFilter
+	{
+		FGameplayTagContainer FilterTags;
+		uint64 Mask;
+		bool bExact;
+	};
+
+	/** Bit of each registered tag */
+	TMap<FGameplayTag, int32> TagBits;
+
+	/** Cached result of GetEventMask, cleared when a tag is registered */
+	TMap<FGameplayTag, uint64> EventMasks;
+
+	/** Filters each ability class has used, abilities usually have one or two */
+	TMap<FObjectKey, TArray<FCompiledFilter, TInlineAllocator<2>>> ClassFilters;
+};
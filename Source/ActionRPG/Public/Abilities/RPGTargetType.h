@@ -9,6 +9,7 @@
 
 class ARPGCharacterBase;
 class AActor;
+class URPGSpatialHashSubsystem;
 struct FGameplayEventData;
 
 /**
@@ -59,3 +60,95 @@ public:
 	/** Uses the passed in event data */
 	virtual void GetTargets_Implementation(ARPGCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
 };
+
+/**
+ * Base for native area target types, finds characters through URPGSpatialHashSubsystem instead of a physics trace
+ * Blueprint subclasses set the shape, and each target comes out as a hit result at that character
+ */
+UCLASS(Abstract)
+class ACTIONRPG_API URPGTargetType_SpatialQuery : public URPGTargetType
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor and overrides
+	URPGTargetType_SpatialQuery();
+
+	/** Finds the characters in the shape and filters them */
+	virtual void GetTargets_Implementation(ARPGCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
+
+	/** Offset of the shape from the targeting actor, in the actor's space */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Targeting)
+	FVector Offset;
+
+	/** If true, the targeting character is never a target */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Targeting)
+	bool bIgnoreTargetingCharacter;
+
+	/** If true, characters on the same side as the targeting character are skipped, sides being player controlled or not */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Targeting)
+	bool bIgnoreSameSide;
+
+protected:
+	/** Adds the characters inside the shape, Origin and Forward already include the offset */
+	virtual void QueryCharacters(URPGSpatialHashSubsystem* SpatialHash, const FVector& Origin, const FVector& Forward, TArray<ARPGCharacterBase*>& OutCharacters) const {}
+};
+
+/** Targets every character within a radius */
+UCLASS()
+class ACTIONRPG_API URPGTargetType_Sphere : public URPGTargetType_SpatialQuery
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor and overrides
+	URPGTargetType_Sphere();
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Targeting)
+	float Radius;
+
+protected:
+	virtual void QueryCharacters(URPGSpatialHashSubsystem* SpatialHash, const FVector& Origin, const FVector& Forward, TArray<ARPGCharacterBase*>& OutCharacters) const override;
+};
+
+/** Targets every character in a flat cone in front of the targeting actor */
+UCLASS()
+class ACTIONRPG_API URPGTargetType_Cone : public URPGTargetType_SpatialQuery
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor and overrides
+	URPGTargetType_Cone();
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Targeting)
+	float Length;
+
+	/** Half of the cone's opening angle, in degrees */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Targeting, meta = (ClampMin = "0.0", ClampMax = "180.0"))
+	float HalfAngle;
+
+protected:
+	virtual void QueryCharacters(URPGSpatialHashSubsystem* SpatialHash, const FVector& Origin, const FVector& Forward, TArray<ARPGCharacterBase*>& OutCharacters) const override;
+};
+
+/** Targets every character along a path in front of the targeting actor, like a sphere sweep */
+UCLASS()
+class ACTIONRPG_API URPGTargetType_Capsule : public URPGTargetType_SpatialQuery
+{
+	GENERATED_BODY()
+
+public:
+	// Constructor and overrides
+	URPGTargetType_Capsule();
+
+	/** Distance the path runs forward */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Targeting)
+	float Length;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Targeting)
+	float Radius;
+
+protected:
+	virtual void QueryCharacters(URPGSpatialHashSubsystem* SpatialHash, const FVector& Origin, const FVector& Forward, TArray<ARPGCharacterBase*>& OutCharacters) const override;
+};
@@ -4,6 +4,7 @@
 
 #include "ActionRPG.h"
 #include "Styling/SlateBrush.h"
+#include "Engine/DataTable.h"
 #include "RPGTypes.h"
 #include "RPGItem.generated.h"
 
@@ -59,4 +60,74 @@ public:
 	/** Ability level this item grants. <= 0 means the character level */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Abilities)
 	int32 AbilityLevel;
-};
\ No newline at end of file
+};
+
+/**
+ * Data table row describing a single item with soft references
+ * Tables of these are compiled into the item catalog without loading icons, abilities or weapon actors, which are streamed in on demand
+ * The row name is used as the item key
+ */
+USTRUCT(BlueprintType)
+struct ACTIONRPG_API FRPGItemDefinitionRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+public:
+	/** Constructor */
+	FRPGItemDefinitionRow()
+		: ItemType(ERPGItemType::Undefined)
+		, Price(0)
+		, MaxCount(1)
+		, MaxLevel(1)
+		, AbilityLevel(1)
+		, WeaponPoolPrewarmCount(0)
+	{}
+
+	/** Type of this item, selects which catalog array the item is added to */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Item)
+	ERPGItemType ItemType;
+
+	/** User-visible short name */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Item)
+	FText ItemName;
+
+	/** User-visible long description */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Item)
+	FText ItemDescription;
+
+	/** Brush settings for the icon, the resource is ignored and replaced by ItemIconResource once it is loaded */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Item)
+	FSlateBrush ItemIcon;
+
+	/** Texture or material to display as the icon */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Item, meta = (AllowedClasses = "Texture,MaterialInterface"))
+	TSoftObjectPtr<UObject> ItemIconResource;
+
+	/** Price in game */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Item)
+	int32 Price;
+
+	/** Maximum number of instances that can be in inventory at once, <= 0 means infinite */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Max)
+	int32 MaxCount;
+
+	/** Maximum level this item can be, <= 0 means infinite */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Max)
+	int32 MaxLevel;
+
+	/** Ability to grant if this item is slotted */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Abilities)
+	TSoftClassPtr<URPGGameplayAbility> GrantedAbility;
+
+	/** Ability level this item grants. <= 0 means the character level */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Abilities)
+	int32 AbilityLevel;
+
+	/** Weapon actor to spawn, only used by weapons */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon)
+	TSoftClassPtr<AActor> WeaponActor;
+
+	/** Number of weapon actors to spawn into the pool ahead of time, only used by weapons */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon)
+	int32 WeaponPoolPrewarmCount;
+};
@@ -0,0 +1,147 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Items/RPGItem.h"
+#include "Items/RPGPotionItem.h"
+#include "Items/RPGSkillItem.h"
+#include "Items/RPGTokenItem.h"
+#include "Items/RPGWeaponItem.h"
+#include "RPGItemCatalog.generated.h"
+
+class UDataTable;
+
+/** Soft references of an item that came from a definition table, empty for items defined inline on the game instance */
+struct FRPGItemSoftReferences
+{
+	FSoftObjectPath ItemIcon;
+	FSoftObjectPath GrantedAbility;
+	FSoftObjectPath WeaponActor;
+};
+
+/**
+ * Compiled, read only view of every item definition on the game instance
+ * Each item key is interned to an FName and given a FRPGItemId, items of each type are stored contiguously
+ * Lookups by id are a bounds check and an array index, lookups by key hash an FName instead of a full FString
+ */
+USTRUCT()
+struct ACTIONRPG_API FRPGItemCatalog
+{
+	GENERATED_BODY()
+
+public:
+	/** Constructor */
+	FRPGItemCatalog()
+		: Fingerprint(0)
+	{}
+
+	/**
+	 * Rebuilds the catalog from the item maps and any FRPGItemDefinitionRow tables, all previously returned ids and pointers become invalid
+	 * Table rows only reference their assets softly, those are filled in by ApplyLoadedAssets once they are in memory
+	 */
+	void Build(const TMap<FString, FRPGPotionItemStruct>& InPotions, const TMap<FString, FRPGSkillItemStruct>& InSkills, const TMap<FString, FRPGTokenItemStruct>& InTokens, const TMap<FString, FRPGWeaponItemStruct>& InWeapons, const TArray<const UDataTable*>& DefinitionTables);
+
+	/** Empties the catalog */
+	void Reset();
+
+	/** Returns the id of the item with this key and type, invalid if not found */
+	FRPGItemId FindItemId(FName ItemKey, ERPGItemType ItemType) const;
+
+	/** Returns the id of the item with this key regardless of type with a single lookup, invalid if not found */
+	FRPGItemId FindAnyItemId(FName ItemKey) const;
+
+	/** Returns the key an id was built from, NAME_None if the id is invalid */
+	FName GetItemKey(const FRPGItemId& ItemId) const;
+
+	/** Returns true if the id points at a valid entry */
+	bool IsValidId(const FRPGItemId& ItemId) const;
+
+	/** Returns a hash of every key in id order, it changes whenever an id could point at a different item */
+	uint32 GetFingerprint() const
+	{
+		return Fingerprint;
+	}
+
+	/** Returns the number of items of a type */
+	int32 Num(ERPGItemType ItemType) const;
+
+	/** Returns the base data of an item, or null if the id is invalid */
+	const FRPGItemStruct* GetItem(const FRPGItemId& ItemId) const;
+
+	/** Typed accessors, return null if the index is out of range */
+	const FRPGPotionItemStruct* GetPotion(int32 Index) const { return Potions.IsValidIndex(Index) ? &Potions[Index] : nullptr; }
+	const FRPGSkillItemStruct* GetSkill(int32 Index) const { return Skills.IsValidIndex(Index) ? &Skills[Index] : nullptr; }
+	const FRPGTokenItemStruct* GetToken(int32 Index) const { return Tokens.IsValidIndex(Index) ? &Tokens[Index] : nullptr; }
+	const FRPGWeaponItemStruct* GetWeapon(int32 Index) const { return Weapons.IsValidIndex(Index) ? &Weapons[Index] : nullptr; }
+
+	/**
+	 * Returns a map of key to base item data for one type, or for all types if Undefined is passed
+	 * Views are built on first use and kept until the catalog is rebuilt or the type is invalidated
+	 */
+	const TMap<FString, FRPGItemStruct>& GetBaseInfoView(ERPGItemType ItemType) const;
+
+	/** Drops the cached view for a type and the all types view, call after modifying items of that type in place */
+	void InvalidateBaseInfoViews(ERPGItemType ItemType);
+
+	/** Appends the soft references of an item that are not loaded yet */
+	void GetUnloadedAssets(const FRPGItemId& ItemId, TArray<FSoftObjectPath>& OutAssets) const;
+
+	/** Returns true if every soft reference of the item has been resolved */
+	bool AreAssetsLoaded(const FRPGItemId& ItemId) const;
+
+	/** Copies any loaded soft references into the item, returns true if the item changed */
+	bool ApplyLoadedAssets(const FRPGItemId& ItemId);
+
+	/** Clears the resolved soft references of every item of a type so the assets can be garbage collected, except for the items in use */
+	void ReleaseLoadedAssets(ERPGItemType ItemType, const TSet<FRPGItemId>& ItemsInUse);
+
+	/** Converts a string key to the interned name without adding to the name table, keys that were never interned return NAME_None */
+	static FName MakeKeyName(const FString& ItemKey)
+	{
+		return ItemKey.IsEmpty() ? NAME_None : FName(*ItemKey, FNAME_Find);
+	}
+
+private:
+	/** Adds keys for one item type, item arrays must already be filled */
+	template<typename ItemStructType>
+	void BuildType(ERPGItemType ItemType, const TMap<FString, ItemStructType>& InItems, TArray<ItemStructType>& OutItems);
+
+	/** Adds a single table row to the end of the array for its type */
+	void AddDefinitionRow(FName ItemKey, const FRPGItemDefinitionRow& Row);
+
+	/** Returns a mutable item, only used while building or resolving assets */
+	FRPGItemStruct* GetMutableItem(const FRPGItemId& ItemId);
+
+	/** Item storage, one contiguous array per type */
+	UPROPERTY()
+	TArray<FRPGPotionItemStruct> Potions;
+
+	UPROPERTY()
+	TArray<FRPGSkillItemStruct> Skills;
+
+	UPROPERTY()
+	TArray<FRPGTokenItemStruct> Tokens;
+
+	UPROPERTY()
+	TArray<FRPGWeaponItemStruct> Weapons;
+
+	/** Key of every item, parallel to the item arrays above, indexed by ERPGItemType */
+	TArray<FName> Keys[(int32)ERPGItemType::Undefined];
+
+	/** Soft references of every item, parallel to the item arrays above, indexed by ERPGItemType */
+	TArray<FRPGItemSoftReferences> SoftReferences[(int32)ERPGItemType::Undefined];
+
+	/** Key to dense index, indexed by ERPGItemType */
+	TMap<FName, int32> KeyToIndex[(int32)ERPGItemType::Undefined];
+
+	/** Cached results of GetBaseInfoView, indexed by ERPGItemType with Undefined holding all types. Objects are kept alive by the arrays above */
+	mutable TMap<FString, FRPGItemStruct> BaseInfoViews[(int32)ERPGItemType::Undefined + 1];
+	mutable bool bBaseInfoViewValid[(int32)ERPGItemType::Undefined + 1] = {};
+
+	/** Key to type and index across all types. If a key exists in several types the first in ERPGItemType order wins */
+	TMap<FName, FRPGItemId> UnifiedIndex;
+
+	/** See GetFingerprint */
+	uint32 Fingerprint;
+};
@@ -15,6 +15,7 @@ public:
 	/** Constructor */
 	FRPGWeaponItemStruct()
 		: FRPGItemStruct()
+		, PoolPrewarmCount(0)
 	{
 		ItemType = ERPGItemType::Weapon;
 	}
@@ -22,4 +23,8 @@ public:
 	/** Weapon actor to spawn */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon)
 	TSubclassOf<AActor> WeaponActor;
+
+	/** Number of weapon actors URPGWeaponPoolSubsystem spawns ahead of time, set this for weapons many enemies carry */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Weapon)
+	int32 PoolPrewarmCount;
 };
\ No newline at end of file
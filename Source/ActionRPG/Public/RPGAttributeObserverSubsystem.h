@@ -0,0 +1,124 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "GameplayEffectTypes.h"
+#include "RPGAttributeObserverSubsystem.generated.h"
+
+class ARPGCharacterBase;
+
+/** The attributes a HUD or health bar shows for one character */
+USTRUCT(BlueprintType)
+struct ACTIONRPG_API FRPGAttributeSnapshot
+{
+	GENERATED_BODY()
+
+	FRPGAttributeSnapshot()
+		: Character(nullptr)
+		, Health(0.f)
+		, MaxHealth(0.f)
+		, Mana(0.f)
+		, MaxMana(0.f)
+		, MoveSpeed(0.f)
+	{}
+
+	UPROPERTY(BlueprintReadOnly, Category = Attributes)
+	ARPGCharacterBase* Character;
+
+	UPROPERTY(BlueprintReadOnly, Category = Attributes)
+	float Health;
+
+	UPROPERTY(BlueprintReadOnly, Category = Attributes)
+	float MaxHealth;
+
+	UPROPERTY(BlueprintReadOnly, Category = Attributes)
+	float Mana;
+
+	UPROPERTY(BlueprintReadOnly, Category = Attributes)
+	float MaxMana;
+
+	UPROPERTY(BlueprintReadOnly, Category = Attributes)
+	float MoveSpeed;
+};
+
+/** Called with the latest attributes of a watched character, at most once per frame */
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnRPGAttributesChanged, const FRPGAttributeSnapshot&, Snapshot);
+
+/** Called once per frame with every character whose attributes changed that frame */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRPGAttributeBatch, const TArray<FRPGAttributeSnapshot>&, Snapshots);
+
+/**
+ * Pushes attribute changes to widgets instead of widgets polling the character getters every frame
+ * Characters register themselves on BeginPlay, attribute change delegates on their ability system mark them dirty,
+ * and once per frame every dirty character sends one snapshot to each of its watchers
+ * Not created on dedicated servers, which have no widgets. Changes to characters nobody watches are ignored while OnAttributeBatch is unbound
+ */
+UCLASS()
+class ACTIONRPG_API URPGAttributeObserverSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Starts listening to the attributes of a character, called by the character */
+	void RegisterCharacter(ARPGCharacterBase* Character);
+
+	/** Stops listening to a character and drops its watchers, called by the character */
+	void UnregisterCharacter(ARPGCharacterBase* Character);
+
+	/** Calls the delegate with the current attributes now, then once per frame whenever they change. Watching again with the same delegate does nothing */
+	UFUNCTION(BlueprintCallable, Category = Attributes)
+	void WatchCharacter(ARPGCharacterBase* Character, FOnRPGAttributesChanged OnChanged);
+
+	/** Stops calling a delegate passed to WatchCharacter */
+	UFUNCTION(BlueprintCallable, Category = Attributes)
+	void UnwatchCharacter(ARPGCharacterBase* Character, FOnRPGAttributesChanged OnChanged);
+
+	/** Returns the current attributes of a character */
+	UFUNCTION(BlueprintPure, Category = Attributes)
+	static FRPGAttributeSnapshot MakeSnapshot(ARPGCharacterBase* Character);
+
+	/** Called once per frame with all characters that changed, for HUDs that show many characters at once */
+	UPROPERTY(BlueprintAssignable, Category = Attributes)
+	FOnRPGAttributeBatch OnAttributeBatch;
+
+	/** Returns the subsystem for the world of an object */
+	static URPGAttributeObserverSubsystem* Get(const UObject* WorldContextObject);
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+protected:
+	/** Everything known about one registered character */
+	struct FObservedCharacter
+	{
+		TArray<FOnRPGAttributesChanged> Watchers;
+		TArray<TPair<FGameplayAttribute, FDelegateHandle>, TInlineAllocator<5>> AttributeHandles;
+		bool bDirty = false;
+	};
+
+	/** Bound to the attribute change delegates of each registered character */
+	void OnAttributeChanged(const FOnAttributeChangeData& ChangeData, TWeakObjectPtr<ARPGCharacterBase> Character);
+
+	/** Returns true if anything would receive a snapshot of the character */
+	bool HasListeners(const FObservedCharacter& Observed) const
+	{
+		return Observed.Watchers.Num() > 0 || OnAttributeBatch.IsBound();
+	}
+
+	/** Removes the attribute bindings of a character */
+	void UnbindCharacter(ARPGCharacterBase* Character, FObservedCharacter& Observed);
+
+	TMap<TWeakObjectPtr<ARPGCharacterBase>, FObservedCharacter> ObservedCharacters;
+
+	/** Characters changed since the last tick, each at most once */
+	TArray<TWeakObjectPtr<ARPGCharacterBase>> DirtyCharacters;
+};
@@ -53,10 +53,14 @@ public:
 	UFUNCTION(BlueprintPure, Category = Ability)
 	static bool DoesEffectContainerSpecHaveTargets(const FRPGGameplayEffectContainerSpec& ContainerSpec);
 
-	/** Adds targets to a copy of the passed in effect container spec and returns it */
+	/** Adds targets to a copy of the passed in effect container spec and returns it. All hit results become one target data entry, see FRPGGameplayEffectContainerSpec::TargetData */
 	UFUNCTION(BlueprintCallable, Category = Ability, meta = (AutoCreateRefTerm = "HitResults,TargetActors"))
 	static FRPGGameplayEffectContainerSpec AddTargetsToEffectContainerSpec(const FRPGGameplayEffectContainerSpec& ContainerSpec, const TArray<FHitResult>& HitResults, const TArray<AActor*>& TargetActors);
 
+	/** Adds targets to the passed in effect container spec directly, without copying it. All hit results become one target data entry */
+	UFUNCTION(BlueprintCallable, Category = Ability, meta = (AutoCreateRefTerm = "HitResults,TargetActors"))
+	static void AddTargetsToEffectContainerSpecInPlace(UPARAM(ref) FRPGGameplayEffectContainerSpec& ContainerSpec, const TArray<FHitResult>& HitResults, const TArray<AActor*>& TargetActors);
+
 	/** Applies container spec that was made from an ability */
 	UFUNCTION(BlueprintCallable, Category = Ability)
 	static TArray<FActiveGameplayEffectHandle> ApplyExternalEffectContainerSpec(const FRPGGameplayEffectContainerSpec& ContainerSpec);
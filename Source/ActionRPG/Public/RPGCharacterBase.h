@@ -9,6 +9,8 @@
 #include "AbilitySystemInterface.h"
 #include "Abilities/RPGAbilitySystemComponent.h"
 #include "Abilities/RPGAttributeSet.h"
+#include "RPGDamageEventSubsystem.h"
+#include "Abilities/RPGAbilityLoadout.h"
 #include "RPGCharacterBase.generated.h"
 
 class URPGGameInstanceBase;
@@ -24,6 +26,8 @@ class ACTIONRPG_API ARPGCharacterBase : public ACharacter, public IAbilitySystem
 public:
 	// Constructor and overrides
 	ARPGCharacterBase();
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void PossessedBy(AController* NewController) override;
 	virtual void UnPossessed() override;
 	virtual void OnRep_Controller() override;
@@ -72,6 +76,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Abilities")
 	void GetActiveAbilitiesWithItemSlot(FRPGItemSlot ItemSlot, TArray<URPGGameplayAbility*>& ActiveAbilities);
 
+	/** Returns true if the ability bound to the item slot is currently running, cheaper than getting the list when only that is needed */
+	UFUNCTION(BlueprintCallable, Category = "Abilities")
+	bool IsAbilityActiveWithItemSlot(FRPGItemSlot ItemSlot) const;
+
 	/**
 	 * Attempts to activate all abilities that match the specified tags
 	 * Returns true if it thinks it activated, but it may return false positives due to failure later in activation.
@@ -80,14 +88,29 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Abilities")
 	bool ActivateAbilitiesWithTags(FGameplayTagContainer AbilityTags, bool bAllowRemoteActivation = true);
 
+	/**
+	 * Calls ActivateAbilitiesWithTags on every character in the list, for AI directors driving many pawns at once
+	 * Returns the number of characters that it thinks activated an ability
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Abilities")
+	static int32 ActivateAbilitiesWithTagsOnCharacters(const TArray<ARPGCharacterBase*>& Characters, FGameplayTagContainer AbilityTags, bool bAllowRemoteActivation = true);
+
 	/** Returns a list of active abilities matching the specified tags. This only returns if the ability is currently running */
 	UFUNCTION(BlueprintCallable, Category = "Abilities")
 	void GetActiveAbilitiesWithTags(FGameplayTagContainer AbilityTags, TArray<URPGGameplayAbility*>& ActiveAbilities);
 
+	/** Returns true if any ability matching the specified tags is currently running, cheaper than getting the list when only that is needed */
+	UFUNCTION(BlueprintCallable, Category = "Abilities")
+	bool IsAnyAbilityActiveWithTags(FGameplayTagContainer AbilityTags) const;
+
 	/** Returns total time and remaining time for cooldown tags. Returns false if no active cooldowns found */
 	UFUNCTION(BlueprintCallable, Category = "Abilities")
 	bool GetCooldownRemainingForTag(FGameplayTagContainer CooldownTags, float& TimeRemaining, float& CooldownDuration);
 
+	/** Returns the cooldown of every slotted ability in one call, for HUDs that show all slots. Slots without a cooldown are included as not on cooldown */
+	UFUNCTION(BlueprintCallable, Category = "Abilities")
+	void GetSlottedAbilityCooldowns(TArray<FRPGSlottedAbilityCooldown>& OutCooldowns);
+
 protected:
 	/** The level of this character, should not be modified directly once it has already spawned */
 	UPROPERTY(EditAnywhere, Replicated, Category = Abilities)
@@ -105,6 +128,10 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Abilities)
 	TArray<TSubclassOf<UGameplayEffect>> PassiveGameplayEffects;
 
+	/** If true, damage taken is reported once per frame through OnDamagedBatch instead of per hit through OnDamaged */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Abilities)
+	bool bBatchDamageEvents;
+
 	/** The component used to handle ability system interactions */
 	UPROPERTY()
 	URPGAbilitySystemComponent* AbilitySystemComponent;
@@ -121,6 +148,9 @@ protected:
 	UPROPERTY()
 	int32 bAbilitiesInitialized;
 
+	/** What the startup loadout granted, used to re-level and remove it */
+	FRPGGrantedAbilityLoadout GrantedLoadout;
+
 	/** Map of slot to ability granted by that slot. I may refactor this later */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
 	TMap<FRPGItemSlot, FGameplayAbilitySpecHandle> SlottedAbilities;
@@ -128,6 +158,8 @@ protected:
 	/** Delegate handles */
 	FDelegateHandle InventoryUpdateHandle;
 	FDelegateHandle InventoryLoadedHandle;
+	FDelegateHandle InventoryChangeSetHandle;
+	FDelegateHandle ItemAssetsLoadedHandle;
 
 	/**
 	 * Called when character takes damage, which may have killed them
@@ -141,6 +173,16 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnDamaged(float DamageAmount, const FHitResult& HitInfo, const struct FGameplayTagContainer& DamageTags, ARPGCharacterBase* InstigatorCharacter, AActor* DamageCauser);
 
+	/**
+	 * Called once per frame with every hit taken that frame, instead of OnDamaged, if bBatchDamageEvents is set
+	 * OnHealthChanged is also called once with the total
+	 *
+	 * @param DamageEvents The hits taken this frame in the order they happened
+	 * @param TotalDamage Sum of the damage amounts
+	 */
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnDamagedBatch(const TArray<FRPGDamageEvent>& DamageEvents, float TotalDamage);
+
 	/**
 	 * Called when health is changed, either from healing or from being damaged
 	 * For damage this is called in addition to OnDamaged/OnKilled
@@ -173,23 +215,56 @@ protected:
 	void OnItemSlotChanged(FRPGItemSlot ItemSlot, FString ItemKey, ERPGItemType ItemType);
 	void RefreshSlottedGameplayAbilities();
 
+	/** Grants or clears the ability of a single slot, only touching the ability system if the slot's ability changed */
+	void RefreshSlottedGameplayAbility(const FRPGItemSlot& ItemSlot);
+
+	/** Called when an inventory transaction is committed, refreshes only the slots that changed */
+	void OnInventoryChangeSet(const FRPGInventoryChangeSet& ChangeSet);
+
+	/** Called when streamed item assets are applied to the catalog, slotted items may now have their granted ability */
+	void OnItemAssetsLoaded(ERPGItemType ItemType);
+
 	/** Apply the startup gameplay abilities and effects */
 	void AddStartupGameplayAbilities();
 
 	/** Attempts to remove any startup gameplay abilities */
 	void RemoveStartupGameplayAbilities();
 
+	/** Applies the passive gameplay effects at the current character level, part of AddStartupGameplayAbilities */
+	void ApplyPassiveGameplayEffects();
+
+	/** Moves the startup abilities, slotted abilities and optionally the passive effects to the current character level in place */
+	void RelevelStartupGameplayAbilities(bool bRelevelPassiveEffects = true);
+
+	/** Returns the startup ability loadout of this character */
+	TSharedRef<const FRPGAbilityLoadout> GetAbilityLoadout() const;
+
+	/** Called by the enemy pool on release, stops all abilities and effects and leaves the subsystems that track live characters */
+	virtual void DeactivateForPool();
+
+	/**
+	 * Called by the enemy pool before handing the character out, returns the ability system to the state AddStartupGameplayAbilities left it in
+	 * Granted abilities are kept and re-leveled in place, attributes are reset and passives applied again
+	 *
+	 * @param NewLevel Level to use, the class default level if 0 or less
+	 */
+	virtual void ActivateFromPool(int32 NewLevel);
+
 	/** Adds slotted item abilities if needed */
 	void AddSlottedGameplayAbilities();
 
 	/** Fills in with ability specs, based on defaults and inventory */
 	void FillSlottedAbilitySpecs(TMap<FRPGItemSlot, FGameplayAbilitySpec>& SlottedAbilitySpecs);
 
+	/** Makes the ability spec a single slot should grant, based on defaults and inventory. Returns false if the slot grants nothing */
+	bool MakeSlottedAbilitySpec(const FRPGItemSlot& ItemSlot, FGameplayAbilitySpec& OutSpec);
+
 	/** Remove slotted gameplay abilities, if force is false it only removes invalid ones */
 	void RemoveSlottedGameplayAbilities(bool bRemoveAll);
 
 	// Called from RPGAttributeSet, these call BP events above
 	virtual void HandleDamage(float DamageAmount, const FHitResult& HitInfo, const struct FGameplayTagContainer& DamageTags, ARPGCharacterBase* InstigatorCharacter, AActor* DamageCauser);
+	virtual void HandleDamageEvents(const TArray<FRPGDamageEvent>& DamageEvents);
 	virtual void HandleHealthChanged(float DeltaValue, const struct FGameplayTagContainer& EventTags);
 	virtual void HandleManaChanged(float DeltaValue, const struct FGameplayTagContainer& EventTags);
 	virtual void HandleMoveSpeedChanged(float DeltaValue, const struct FGameplayTagContainer& EventTags);
@@ -199,6 +274,10 @@ protected:
 
 	// Friended to allow access to handle functions above
 	friend URPGAttributeSet;
+	friend URPGDamageEventSubsystem;
+
+	// Friended to allow access to the pool functions above
+	friend class URPGEnemyPoolSubsystem;
 
 private:
 	URPGGameInstanceBase* GameInstance;
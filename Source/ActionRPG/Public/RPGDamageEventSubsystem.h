@@ -0,0 +1,92 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "GameplayTagContainer.h"
+#include "RPGDamageEventSubsystem.generated.h"
+
+class ARPGCharacterBase;
+
+/** A single application of damage, recorded in PostGameplayEffectExecute and dispatched at the end of the frame */
+USTRUCT(BlueprintType)
+struct ACTIONRPG_API FRPGDamageEvent
+{
+	GENERATED_BODY()
+
+	FRPGDamageEvent()
+		: TargetCharacter(nullptr)
+		, InstigatorCharacter(nullptr)
+		, DamageCauser(nullptr)
+		, DamageAmount(0.f)
+		, HitLocation(ForceInit)
+	{}
+
+	/** Character that took the damage */
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	ARPGCharacterBase* TargetCharacter;
+
+	/** Character that initiated the damage, can be null */
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	ARPGCharacterBase* InstigatorCharacter;
+
+	/** The actual actor that did the damage, might be a weapon or projectile */
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	AActor* DamageCauser;
+
+	/** Amount of damage that was done, not clamped based on current health */
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	float DamageAmount;
+
+	/** Impact point of the hit, zero if the effect had no hit result */
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	FVector HitLocation;
+
+	/** The gameplay tags of the event that did the damage */
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	FGameplayTagContainer DamageTags;
+};
+
+/** Called once per frame with every damage event of the frame */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRPGDamageEvents, const TArray<FRPGDamageEvent>&, DamageEvents);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnRPGDamageEventsNative, const TArray<FRPGDamageEvent>&);
+
+/**
+ * Collects damage events during the frame and dispatches them in one batch
+ * Characters with bBatchDamageEvents set get a single HandleDamageEvents call per frame instead of HandleDamage per hit
+ */
+UCLASS()
+class ACTIONRPG_API URPGDamageEventSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Adds an event to be dispatched at the end of the frame */
+	void QueueDamageEvent(FRPGDamageEvent&& DamageEvent);
+
+	/** Dispatches everything queued so far, normally called from Tick */
+	void DispatchDamageEvents();
+
+	/** Called once per frame with all damage events of the frame, for damage numbers and combat logs */
+	UPROPERTY(BlueprintAssignable, Category = Damage)
+	FOnRPGDamageEvents OnDamageEvents;
+
+	/** Native version above, called before BP delegate */
+	FOnRPGDamageEventsNative OnDamageEventsNative;
+
+	/** Returns the subsystem for the world of an object */
+	static URPGDamageEventSubsystem* Get(const UObject* WorldContextObject);
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+protected:
+	/** Events of the current frame, a property so references to destroyed actors are cleared by garbage collection */
+	UPROPERTY(Transient)
+	TArray<FRPGDamageEvent> PendingEvents;
+};
@@ -0,0 +1,81 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RPGPoolableInterface.h"
+#include "RPGEnemyPoolSubsystem.generated.h"
+
+class ARPGCharacterBase;
+
+/** How many enemies of one class a wave spawns, used to size the pool */
+USTRUCT(BlueprintType)
+struct ACTIONRPG_API FRPGEnemySpawnCount
+{
+	GENERATED_BODY()
+
+	FRPGEnemySpawnCount()
+		: Count(0)
+	{}
+
+	/** Class to spawn */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Pool)
+	TSubclassOf<ARPGCharacterBase> CharacterClass;
+
+	/** Number of that class spawned */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Pool)
+	int32 Count;
+};
+
+/**
+ * Recycles enemy characters instead of spawning a character, ability system and attribute set for every enemy of every wave
+ * Released enemies lose their controller, are hidden and have collision and tick disabled until they are acquired again
+ * Acquiring resets the ability system through ARPGCharacterBase::ActivateFromPool and spawns a new default controller
+ * Characters implementing RPGPoolableInterface are told when they enter and leave the pool, for blueprint state such as death flags
+ */
+UCLASS()
+class ACTIONRPG_API URPGEnemyPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Returns an enemy of the class at the transform, taken from the pool or spawned if the pool is empty
+	 *
+	 * @param CharacterClass Class to spawn
+	 * @param SpawnTransform Where to place the enemy
+	 * @param CharacterLevel Level of the enemy, the class default level if 0 or less
+	 */
+	UFUNCTION(BlueprintCallable, Category = Pool)
+	ARPGCharacterBase* AcquireEnemy(TSubclassOf<ARPGCharacterBase> CharacterClass, const FTransform& SpawnTransform, int32 CharacterLevel = 0);
+
+	/** Puts an enemy back into the pool, use instead of destroying it once its death is over */
+	UFUNCTION(BlueprintCallable, Category = Pool)
+	void ReleaseEnemy(ARPGCharacterBase* Enemy);
+
+	/** Spawns enemies into the pool until it has at least Count free characters of the class */
+	UFUNCTION(BlueprintCallable, Category = Pool)
+	void PrewarmEnemies(TSubclassOf<ARPGCharacterBase> CharacterClass, int32 Count);
+
+	/** Prewarms for one wave, counts of the same class are added up. Calling this for every wave sizes each class for the largest wave */
+	UFUNCTION(BlueprintCallable, Category = Pool)
+	void PrewarmForWave(const TArray<FRPGEnemySpawnCount>& SpawnCounts);
+
+	/** Returns the number of free enemies of a class */
+	UFUNCTION(BlueprintPure, Category = Pool)
+	int32 GetNumFreeEnemies(TSubclassOf<ARPGCharacterBase> CharacterClass) const;
+
+	/** Returns the subsystem for the world of an object */
+	static URPGEnemyPoolSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Deinitialize() override;
+
+protected:
+	/** Spawns an enemy that is not in the pool, without a controller and with its abilities not yet granted */
+	ARPGCharacterBase* SpawnEnemy(UClass* CharacterClass, const FTransform& SpawnTransform);
+
+	/** Free enemies by class */
+	UPROPERTY(Transient)
+	TMap<UClass*, FRPGPooledActorList> FreeEnemies;
+};
@@ -10,8 +10,10 @@
 #include "Items/RPGSkillItem.h"
 #include "Items/RPGTokenItem.h"
 #include "Items/RPGWeaponItem.h"
+#include "Items/RPGItemCatalog.h"
 
 #include "Engine/GameInstance.h"
+#include "Engine/StreamableManager.h"
 #include "RPGGameInstanceBase.generated.h"
 
 class URPGItem;
@@ -42,55 +44,171 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory)
 	TMap<FString, FRPGWeaponItemStruct> Weapons;
 
+	/**
+	 * Data tables using FRPGItemDefinitionRow, the row name is the item key
+	 * Rows only softly reference their icon, ability and weapon actor, use RequestItemAssets or PreloadItemType to stream them in
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory)
+	TArray<TSoftObjectPtr<UDataTable>> ItemDefinitionTables;
+
+	/** Maximum number of items requested in a single async load by PreloadItemType */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory)
+	int32 ItemPreloadBatchSize;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory)
 	TMap<FString, FRPGItemData> DefaultInventoryItems;
 
+	/** Key of the token item spent by PurchaseItem, purchases fail if this is empty */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory)
+	FString PurchaseTokenKey;
+
+	/** The slot name used for saving */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Save)
+	FString SaveSlot;
+
+	/** The platform-specific user index */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Save)
+	int32 SaveUserIndex;
+
 	/** Number of slots for each type of item */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory, DisplayName = "Item Slots Per Type")
 	TMap<ERPGItemType, int32> SlotsPerItemType;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	bool ItemExists(FString ItemKey, ERPGItemType ItemType) const;
+	bool ItemExists(const FString& ItemKey, ERPGItemType ItemType) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	bool TryGetPotion(FString PotionKey, FRPGPotionItemStruct& outPotion) const;
+	bool TryGetPotion(const FString& PotionKey, FRPGPotionItemStruct& outPotion) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	FRPGPotionItemStruct GetPotion(FString PotionKey) const;
+	FRPGPotionItemStruct GetPotion(const FString& PotionKey) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	bool TryGetSkill(FString SkillKey, FRPGSkillItemStruct& outSkill) const;
+	bool TryGetSkill(const FString& SkillKey, FRPGSkillItemStruct& outSkill) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	FRPGSkillItemStruct GetSkill(FString SkillKey) const;
+	FRPGSkillItemStruct GetSkill(const FString& SkillKey) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	bool TryGetToken(FString TokenKey, FRPGTokenItemStruct& outToken) const;
+	bool TryGetToken(const FString& TokenKey, FRPGTokenItemStruct& outToken) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	FRPGTokenItemStruct GetToken(FString TokenKey) const;
+	FRPGTokenItemStruct GetToken(const FString& TokenKey) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	bool TryGetWeapon(FString WeaponKey, FRPGWeaponItemStruct& outWeapon) const;
+	bool TryGetWeapon(const FString& WeaponKey, FRPGWeaponItemStruct& outWeapon) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	FRPGWeaponItemStruct GetWeapon(FString WeaponKey) const;
+	FRPGWeaponItemStruct GetWeapon(const FString& WeaponKey) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	bool TryGetBaseItemData(FString ItemKey, ERPGItemType ItemType, FRPGItemStruct& outItem) const;
+	bool TryGetBaseItemData(const FString& ItemKey, ERPGItemType ItemType, FRPGItemStruct& outItem) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	FRPGItemStruct GetBaseItemData(FString ItemKey, ERPGItemType ItemType) const;
+	FRPGItemStruct GetBaseItemData(const FString& ItemKey, ERPGItemType ItemType) const;
 
 	UFUNCTION(BlueprintCallable, Category = Inventory)
-	bool FindItem(FString ItemKey, ERPGItemType& OutItemType, FRPGItemStruct& OutItemData) const;
+	bool FindItem(const FString& ItemKey, ERPGItemType& OutItemType, FRPGItemStruct& OutItemData) const;
 
+	/** Returns base info for all items of a type, or all items if Undefined is passed. The result is cached until the catalog changes */
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	void GetItemsBaseInfo(ERPGItemType ItemType, TMap<FString, FRPGItemStruct>& OutItems) const;
 
+	/**
+	 * Returns one page of GetItemsBaseInfo, for list widgets that only show part of the store or inventory
+	 * If NameFilter is not empty only items whose key or name contains it are returned. A PageSize <= 0 returns every match
+	 * Returns the total number of items matching the filter, so the caller can work out the page count
+	 */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	int32 GetItemsBaseInfoPage(ERPGItemType ItemType, int32 PageIndex, int32 PageSize, const FString& NameFilter, TArray<FString>& OutKeys, TArray<FRPGItemStruct>& OutItems) const;
+
+	/** Native version of GetItemsBaseInfo that returns the cached view without copying it. Only valid until the catalog changes */
+	const TMap<FString, FRPGItemStruct>& GetItemsBaseInfoView(ERPGItemType ItemType) const;
+
+	/** Returns the catalog id for an item key, invalid if the item does not exist. Resolve once and use the id based functions in hot paths */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	FRPGItemId GetItemId(const FString& ItemKey, ERPGItemType ItemType) const;
+
+	/** Returns the key an item id was resolved from, empty if the id is invalid */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	FString GetItemKeyFromId(FRPGItemId ItemId) const;
+
+	/** Returns true if the id points at an item in the catalog */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	bool ItemIdExists(FRPGItemId ItemId) const;
+
+	/** Id based version of TryGetBaseItemData, does not hash the key */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool TryGetBaseItemDataById(FRPGItemId ItemId, FRPGItemStruct& outItem) const;
+
+	/** Rebuilds the item catalog from the item maps and definition tables above. Must be called if they are modified after Init */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	void RebuildItemCatalog();
+
+	/**
+	 * Native only accessors that return pointers into the catalog instead of copying the item out
+	 * Pointers are only valid until the catalog is rebuilt, so do not store them
+	 * Passing Undefined as the type searches all types, OutItemId is optional
+	 */
+	const FRPGItemStruct* FindBaseItem(const FString& ItemKey, ERPGItemType ItemType, FRPGItemId* OutItemId = nullptr) const;
+	const FRPGItemStruct* FindBaseItem(const FRPGItemId& ItemId) const;
+	const FRPGPotionItemStruct* FindPotion(const FString& PotionKey) const;
+	const FRPGSkillItemStruct* FindSkill(const FString& SkillKey) const;
+	const FRPGTokenItemStruct* FindToken(const FString& TokenKey) const;
+	const FRPGWeaponItemStruct* FindWeapon(const FString& WeaponKey) const;
+
+	/** Returns the compiled item catalog, for native lookups */
+	const FRPGItemCatalog& GetItemCatalog() const
+	{
+		return ItemCatalog;
+	}
+
+	/**
+	 * Streams in the soft referenced assets of items, the delegate is called once they are all applied to the catalog
+	 * If everything is already loaded the delegate is called immediately
+	 */
+	void RequestItemAssets(const TArray<FRPGItemId>& ItemIds, FStreamableDelegate OnLoaded = FStreamableDelegate());
+	void RequestItemAssets(const FRPGItemId& ItemId, FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+	/** Asynchronously loads the assets of every item of a type, or all types if Undefined is passed. OnItemAssetsLoaded is broadcast as each batch completes */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	void PreloadItemType(ERPGItemType ItemType);
+
+	/** Drops the loaded assets of every item of a type so they can be garbage collected, items still in use keep their assets alive */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	void ReleasePreloadedItemType(ERPGItemType ItemType);
+
+	/** Returns true if the soft referenced assets of the item are loaded */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	bool AreItemAssetsLoaded(FRPGItemId ItemId) const;
+
+	/** Delegate called when a batch of item assets finished loading and gave at least one item new assets */
+	UPROPERTY(BlueprintAssignable, Category = Inventory)
+	FOnItemAssetsLoaded OnItemAssetsLoaded;
+
+	/** Native version above, called before BP delegate */
+	FOnItemAssetsLoadedNative OnItemAssetsLoadedNative;
+
 	/** Returns true if this is a valid inventory slot */
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	bool IsValidItemSlot(FRPGItemSlot ItemSlot) const;	
 
 	virtual void Init() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+	/** Compiled from the item maps in Init, all lookups go through this */
+	UPROPERTY(Transient)
+	FRPGItemCatalog ItemCatalog;
+
+	/** Called when an async item asset request completes */
+	void OnItemAssetsLoadComplete(TArray<FRPGItemId> ItemIds, FStreamableDelegate OnLoaded, int32 CatalogGeneration);
+
+	/** Handles of item asset loads still in flight, kept so the loads are not cancelled */
+	TArray<TSharedPtr<FStreamableHandle>> PendingItemAssetLoads;
+
+	/** Incremented every time the catalog is rebuilt, item ids from an older generation are stale */
+	int32 ItemCatalogGeneration;
 };
\ No newline at end of file
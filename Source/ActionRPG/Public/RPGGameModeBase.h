@@ -6,6 +6,45 @@
 #include "GameFramework/GameModeBase.h"
 #include "RPGGameModeBase.generated.h"
 
+class ARPGCharacterBase;
+
+/** One enemy a wave wants spawned */
+USTRUCT(BlueprintType)
+struct ACTIONRPG_API FRPGEnemySpawnRequest
+{
+	GENERATED_BODY()
+
+	FRPGEnemySpawnRequest()
+		: CharacterLevel(0)
+		, Priority(0)
+	{}
+
+	/** Class to spawn */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave)
+	TSubclassOf<ARPGCharacterBase> CharacterClass;
+
+	/** Where to spawn it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave)
+	FTransform SpawnTransform;
+
+	/** Level of the enemy, the class default level if 0 or less */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave)
+	int32 CharacterLevel;
+
+	/** Higher priority spawns go first, before the camera based ordering */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Wave)
+	int32 Priority;
+};
+
+/** Called for every enemy the wave director spawns */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRPGWaveEnemySpawned, ARPGCharacterBase*, Enemy);
+
+/** Called once per frame in which the wave director spawned something */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnRPGWaveSpawnProgress, int32, NumSpawned, int32, NumQueued);
+
+/** Called when the spawn queue runs empty */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnRPGWaveSpawnFinished);
+
 /** Base class for GameMode, should be blueprinted */
 UCLASS()
 class ACTIONRPG_API ARPGGameModeBase : public AGameModeBase
@@ -15,5 +54,71 @@ class ACTIONRPG_API ARPGGameModeBase : public AGameModeBase
 public:
 	/** Constructor */
 	ARPGGameModeBase();
-};
+	virtual void StartPlay() override;
+
+	/**
+	 * Queues enemies to be spawned over the next frames through the enemy pool, instead of all at once
+	 * Requests are ordered once here by priority, then off camera before on camera, then nearest to the player first, then queue order,
+	 * so the same requests from the same view always spawn in the same order
+	 */
+	UFUNCTION(BlueprintCallable, Category = Wave)
+	void QueueWaveSpawns(const TArray<FRPGEnemySpawnRequest>& SpawnRequests);
 
+	/** Drops every spawn that has not happened yet */
+	UFUNCTION(BlueprintCallable, Category = Wave)
+	void CancelWaveSpawns();
+
+	/** Returns true if spawns are still queued */
+	UFUNCTION(BlueprintPure, Category = Wave)
+	bool IsSpawningWave() const;
+
+	/** Called for every spawned enemy, bind death handling here */
+	UPROPERTY(BlueprintAssignable, Category = Wave)
+	FOnRPGWaveEnemySpawned OnWaveEnemySpawned;
+
+	/** Called with the number spawned and queued since the queue was last empty, for wave start widgets */
+	UPROPERTY(BlueprintAssignable, Category = Wave)
+	FOnRPGWaveSpawnProgress OnWaveSpawnProgress;
+
+	/** Called when every queued spawn has happened */
+	UPROPERTY(BlueprintAssignable, Category = Wave)
+	FOnRPGWaveSpawnFinished OnWaveSpawnFinished;
+
+protected:
+	/** A queued request with its sort key */
+	struct FQueuedSpawn
+	{
+		FRPGEnemySpawnRequest Request;
+		float DistanceSquared;
+		int32 Sequence;
+		bool bOnCamera;
+	};
+
+	/** Spawns from the queue until the frame budget is used up */
+	void ProcessSpawnQueue();
+
+	/** Runs ProcessSpawnQueue next frame if it is not already scheduled */
+	void ScheduleSpawnQueue();
+
+	/** Milliseconds per frame the wave director may spend spawning, 0 for no time limit. At least one enemy is spawned per frame */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = Wave)
+	float SpawnBudgetMs;
+
+	/** Most enemies spawned per frame, 0 for no limit. Set the budget to 0 and use this for frame exact reproducible spawning */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = Wave)
+	int32 MaxSpawnsPerFrame;
+
+	/** Spawns not done yet, in spawn order from SpawnQueueHead */
+	TArray<FQueuedSpawn> SpawnQueue;
+	int32 SpawnQueueHead;
+
+	/** Counts since the queue was last empty, reported through OnWaveSpawnProgress */
+	int32 NumWaveSpawned;
+	int32 NumWaveQueued;
+
+	/** Timer running ProcessSpawnQueue once per frame while spawns are queued */
+	FTimerHandle SpawnQueueTimerHandle;
+
+	/** Incremented by CancelWaveSpawns, so a cancel from a spawn delegate stops the current pass */
+	int32 SpawnQueueSerial;
+};
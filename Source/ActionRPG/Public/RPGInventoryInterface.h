@@ -35,5 +35,8 @@ public:
 
 	/** Gets the delegate for when the inventory loads */
 	virtual FOnInventoryLoadedNative& GetInventoryLoadedDelegate() = 0;
+
+	/** Gets the delegate for batched inventory changes, called instead of the per item delegates while a transaction is open */
+	virtual FOnInventoryChangeSetNative& GetInventoryChangeSetDelegate() = 0;
 };
 
@@ -0,0 +1,66 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+
+/**
+ * Slot bookkeeping for an inventory
+ * Slots of each type are stored densely by slot number, with a reverse index from item key to slot and a bit per slot marking it free
+ * Equip, unequip, auto slot and removal are all constant time apart from a word scan of the free bits
+ * An item key can only be in one slot at a time
+ */
+struct ACTIONRPG_API FRPGInventorySlots
+{
+public:
+	/** Sets up empty slots, all existing contents are lost */
+	void Init(const TMap<ERPGItemType, int32>& SlotsPerItemType);
+
+	/** Empties every slot and removes all slots */
+	void Reset();
+
+	/** Returns true if the slot exists */
+	bool IsValidSlot(const FRPGItemSlot& ItemSlot) const
+	{
+		return ItemSlot.IsValid() && ItemSlot.ItemType < ERPGItemType::Undefined && Slots[(int32)ItemSlot.ItemType].IsValidIndex(ItemSlot.SlotNumber);
+	}
+
+	/** Returns the number of slots of a type */
+	int32 Num(ERPGItemType ItemType) const
+	{
+		return ItemType < ERPGItemType::Undefined ? Slots[(int32)ItemType].Num() : 0;
+	}
+
+	/** Returns the key of the item in a slot, empty if the slot is empty or invalid */
+	const FString& GetItem(const FRPGItemSlot& ItemSlot) const;
+
+	/** Returns the slot an item is in, or an invalid slot if it is not slotted */
+	FRPGItemSlot FindItemSlot(const FString& ItemKey) const;
+
+	/** Returns the lowest numbered empty slot of a type, or an invalid slot if they are all full */
+	FRPGItemSlot FindFreeSlot(ERPGItemType ItemType) const;
+
+	/**
+	 * Puts an item in a slot, replacing whatever was there. Passing an empty key empties the slot
+	 * The caller is responsible for clearing any other slot the item was in first
+	 * Returns true if the contents of the slot changed
+	 */
+	bool SetItem(const FRPGItemSlot& ItemSlot, const FString& ItemKey);
+
+	/** Read only access to the slots of a type, indexed by slot number */
+	const TArray<FString>& GetSlots(ERPGItemType ItemType) const
+	{
+		check(ItemType < ERPGItemType::Undefined);
+		return Slots[(int32)ItemType];
+	}
+
+private:
+	/** Slot contents, indexed by ERPGItemType then slot number */
+	TArray<FString> Slots[(int32)ERPGItemType::Undefined];
+
+	/** True bits are empty slots, parallel to Slots */
+	TBitArray<> FreeSlots[(int32)ERPGItemType::Undefined];
+
+	/** Item key to the slot it is in, interned so lookups hash a name instead of the string */
+	TMap<FName, FRPGItemSlot> ItemToSlot;
+};
@@ -6,6 +6,9 @@
 #include "GameFramework/PlayerController.h"
 #include "RPGInventoryInterface.h"
 #include "Items/RPGItem.h"
+#include "RPGInventorySlots.h"
+#include "RPGReplicatedInventory.h"
+#include "RPGSaveGame.h"
 #include "RPGPlayerControllerBase.generated.h"
 
 class URPGGameInstanceBase;
@@ -18,25 +21,26 @@ class ACTIONRPG_API ARPGPlayerControllerBase : public APlayerController, public
 
 public:
 	// Constructor and overrides
-	ARPGPlayerControllerBase() {}
+	ARPGPlayerControllerBase();
 	virtual void BeginPlay() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
-	/** Map of all items owned by this player, from definition to data */
+	/** Map of all items owned by this player, from definition to data. Authoritative on the server, rebuilt from ReplicatedInventory on clients */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
 	TMap<FString, FRPGItemData> InventoryData;
 
-	/** Map of slot, from type/num to item, initialized from ItemSlotsPerType on RPGGameInstanceBase */
+	/** Map of slot, from type/num to item, initialized from ItemSlotsPerType on RPGGameInstanceBase. Mirrors InventorySlots, which is used for all lookups */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory)
 	TMap<FRPGItemSlot, FString> SlottedItems;
 
-	/** Delegate called when an inventory item has been added or removed */
+	/** Delegate called when an inventory item has been added or removed outside of a transaction, see BeginInventoryTransaction */
 	UPROPERTY(BlueprintAssignable, Category = Inventory)
 	FOnInventoryItemChanged OnInventoryItemChanged;
 
 	/** Native version above, called before BP delegate */
 	FOnInventoryItemChangedNative OnInventoryItemChangedNative;
 
-	/** Delegate called when an inventory slot has changed */
+	/** Delegate called when an inventory slot has changed outside of a transaction, see BeginInventoryTransaction */
 	UPROPERTY(BlueprintAssignable, Category = Inventory)
 	FOnSlottedItemChanged OnSlottedItemChanged;
 
@@ -58,6 +62,52 @@ public:
 	/** Native version above, called before BP delegate */
 	FOnInventoryLoadedNative OnInventoryLoadedNative;
 
+	/** Delegate called when an inventory transaction is committed */
+	UPROPERTY(BlueprintAssignable, Category = Inventory)
+	FOnInventoryChangeSet OnInventoryChangeSet;
+
+	/** Native version above, called before BP delegate */
+	FOnInventoryChangeSetNative OnInventoryChangeSetNative;
+
+	/** Called after an inventory transaction was committed and we notified all delegates */
+	UFUNCTION(BlueprintImplementableEvent, Category = Inventory)
+	void InventoryChangeSetCommitted(const FRPGInventoryChangeSet& ChangeSet);
+
+	/**
+	 * Starts batching inventory changes, transactions can be nested
+	 * While a transaction is open the per item and per slot delegates and events are not called, changes are collected instead
+	 * When the outermost transaction is committed only the change set delegates and event are called, once.
+	 * UI that must see changes made in a transaction, such as AddInventoryItems, PurchaseItem and InitInventory, has to bind OnInventoryChangeSet
+	 */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	void BeginInventoryTransaction();
+
+	/** Closes a transaction opened with BeginInventoryTransaction, notifies if this was the outermost one */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	void CommitInventoryTransaction();
+
+	/** Returns true if an inventory transaction is open */
+	UFUNCTION(BlueprintPure, Category = Inventory)
+	bool IsInInventoryTransaction() const
+	{
+		return InventoryTransactionDepth > 0;
+	}
+
+	/** Adds several items inside a single transaction, returns true if anything changed */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool AddInventoryItems(const TMap<FString, FRPGItemData>& NewItems, bool bAutoSlot = true);
+
+	/**
+	 * Functions that modify the inventory only work with authority, clients receive the changes through replication
+	 * and get the same item and slot delegates as the server
+	 * On the owning client PurchaseItem, RemoveInventoryItem and SetSlottedItem send the request to the server and return false,
+	 * the outcome arrives through the item and slot changed delegates once the server applied it. Clients cannot add items directly
+	 */
+
+	/** Adds one of an item and spends its price in PurchaseTokenKey tokens from the game instance, returns false if it could not be afforded or added */
+	UFUNCTION(BlueprintCallable, Category = Inventory)
+	bool PurchaseItem(FString ItemKey, ERPGItemType ItemType, bool bAutoSlot = true);
+
 	/** Adds a new inventory item, will add it to an empty slot if possible. If the item supports count you can add more than one count. It will also update the level when adding if required */
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	bool AddInventoryItem(FString NewItemKey, ERPGItemType ItemType, int32 ItemCount = 1, int32 ItemLevel = 1, bool bAutoSlot = true);
@@ -94,10 +144,28 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	void FillEmptySlots();
 
-	/** Loads inventory from defaults on game instance */
+	/** Loads inventory from the save slot on game instance if there is a save, otherwise from defaults on game instance */
 	UFUNCTION(BlueprintCallable, Category = Inventory)
 	void InitInventory();
 
+	/**
+	 * Saves the inventory to the save slot on game instance if it changed since the last save, only for local controllers since the slot is the local user's
+	 * The inventory is copied on the game thread, then encoded and written in the background. Returns false if nothing needed saving
+	 */
+	UFUNCTION(BlueprintCallable, Category = Save)
+	bool SaveInventory();
+
+	/** Returns true if the inventory changed since it was last saved or loaded */
+	UFUNCTION(BlueprintPure, Category = Save)
+	bool IsInventoryDirty() const
+	{
+		return InventoryRevision != SavedInventoryRevision;
+	}
+
+	/** Called after a save started by SaveInventory has been written */
+	UFUNCTION(BlueprintImplementableEvent, Category = Save)
+	void InventorySaved(bool bSuccess);
+
 	UFUNCTION(BlueprintCallable, Category = Game)
 	URPGGameInstanceBase* GetGameInstance();
 
@@ -122,15 +190,92 @@ public:
 	{
 		return OnInventoryLoadedNative;
 	}
+	virtual FOnInventoryChangeSetNative& GetInventoryChangeSetDelegate() override
+	{
+		return OnInventoryChangeSetNative;
+	}
 
 protected:
 	/** Auto slots a specific item, returns true if anything changed */
 	bool FillEmptySlotWithItem(FString NewItemKey, ERPGItemType ItemType);
 
+	/** Changes the contents of a slot in both InventorySlots and SlottedItems, and ReplicatedSlots on the server. Does not notify */
+	void SetSlotContents(const FRPGItemSlot& ItemSlot, const FString& ItemKey);
+
+	/** Adds, updates or removes an owned item in both InventoryData and ReplicatedInventory. Does not notify */
+	void SetInventoryItemData(const FString& ItemKey, const FRPGItemData& ItemData);
+	void RemoveInventoryItemData(const FString& ItemKey);
+
+	/** Creates empty slots from the game instance settings */
+	void InitInventorySlots();
+
+	/** Copies the inventory into a form that can be encoded off the game thread */
+	void MakeInventorySaveData(FRPGInventorySaveData& OutData);
+
+	/** Reads the save slot, returns false if there is no valid save or this is not a local controller */
+	bool LoadInventorySaveData(FRPGInventorySaveData& OutData);
+
+	/** Fills the empty inventory from loaded save data, items missing from the catalog are dropped */
+	void ApplyInventorySaveData(const FRPGInventorySaveData& Data);
+
+	/** Called on the game thread once the inventory has been encoded, and again once it was written */
+	void OnInventorySaveEncoded(TArray<uint8>&& Bytes, int32 Revision);
+	void OnInventorySaveComplete(const FString& SlotName, const int32 UserIndex, bool bSuccess, int32 Revision);
+
+	/** Incremented on every change on the server, compared against the revision of the last save */
+	int32 InventoryRevision;
+	int32 SavedInventoryRevision;
+
+	/** True while a save is being encoded or written, further requests are queued behind it */
+	bool bInventorySaveInProgress;
+	bool bInventorySaveQueued;
+
+	/** Returns true if the inventory can be modified here, logs a warning if not */
+	bool CheckInventoryAuthority(const TCHAR* FunctionName) const;
+
+	/** Returns true if this is the owning client, which forwards inventory changes to the server */
+	bool ShouldForwardInventoryChange() const;
+
+	/** Server side of the inventory functions when called on the owning client */
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerPurchaseItem(const FString& ItemKey, ERPGItemType ItemType, bool bAutoSlot);
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerRemoveInventoryItem(const FString& RemovedItemKey, int32 RemoveCount);
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerSetSlottedItem(FRPGItemSlot ItemSlot, const FString& ItemKey);
+
+	/** Client side handlers for the replicated lists, keep the local maps in sync and notify */
+	void OnReplicatedItemChanged(const FString& ItemKey, const FRPGItemData& ItemData);
+	void OnReplicatedItemRemoved(const FString& ItemKey);
+	void OnReplicatedSlotChanged(const FRPGItemSlot& ItemSlot, const FString& ItemKey);
+
+	friend struct FRPGInventoryEntry;
+	friend struct FRPGSlottedItemEntry;
+
+	/** Owned items, delta replicated to the owning client */
+	UPROPERTY(Replicated)
+	FRPGInventoryList ReplicatedInventory;
+
+	/** Slot contents, delta replicated to the owning client */
+	UPROPERTY(Replicated)
+	FRPGSlottedItemList ReplicatedSlots;
+
+	/** Dense slot storage with reverse and free slot indices */
+	FRPGInventorySlots InventorySlots;
+
 	/** Calls the inventory update callbacks */
 	void NotifyInventoryItemChanged(bool bAdded, FString ItemKey, ERPGItemType ItemType);
 	void NotifySlottedItemChanged(FRPGItemSlot ItemSlot, FString ItemKey, ERPGItemType ItemType);
 	void NotifyInventoryLoaded();
+	void NotifyInventoryChangeSet();
+
+	/** Number of open inventory transactions */
+	int32 InventoryTransactionDepth;
+
+	/** Changes collected while a transaction is open */
+	FRPGInventoryChangeSet PendingChangeSet;
 
 private:
 	URPGGameInstanceBase* GameInstance;
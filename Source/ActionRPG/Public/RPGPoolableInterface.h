@@ -0,0 +1,40 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "RPGPoolableInterface.generated.h"
+
+/** Free actors of one class, a struct so the pool maps can be properties */
+USTRUCT()
+struct ACTIONRPG_API FRPGPooledActorList
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> Actors;
+};
+
+/**
+ * Interface for actors that are recycled by a pool instead of being spawned and destroyed
+ * Pools hide, detach and disable collision and tick on their own, this is for anything else the actor has to reset
+ */
+UINTERFACE(MinimalAPI, BlueprintType)
+class URPGPoolableInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+class ACTIONRPG_API IRPGPoolableInterface
+{
+	GENERATED_BODY()
+
+public:
+	/** Called when the actor is taken out of a pool, after it has been shown and moved into place */
+	UFUNCTION(BlueprintNativeEvent, Category = Pool)
+	void OnAcquiredFromPool();
+
+	/** Called when the actor goes back into a pool, before it is hidden */
+	UFUNCTION(BlueprintNativeEvent, Category = Pool)
+	void OnReturnedToPool();
+};
@@ -0,0 +1,145 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Engine/NetSerialization.h"
+#include "RPGReplicatedInventory.generated.h"
+
+class ARPGPlayerControllerBase;
+
+/** A single owned item as replicated to the owning client */
+USTRUCT()
+struct ACTIONRPG_API FRPGInventoryEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	FRPGInventoryEntry() {}
+
+	FRPGInventoryEntry(const FString& InItemKey, const FRPGItemData& InItemData)
+		: ItemKey(InItemKey)
+		, ItemData(InItemData)
+	{}
+
+	UPROPERTY()
+	FString ItemKey;
+
+	UPROPERTY()
+	FRPGItemData ItemData;
+
+	/** Client side callbacks, forward to the owning controller */
+	void PreReplicatedRemove(const struct FRPGInventoryList& InArraySerializer);
+	void PostReplicatedAdd(const struct FRPGInventoryList& InArraySerializer);
+	void PostReplicatedChange(const struct FRPGInventoryList& InArraySerializer);
+};
+
+/** Delta replicated list of owned items, only entries marked dirty on the server are sent */
+USTRUCT()
+struct ACTIONRPG_API FRPGInventoryList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	FRPGInventoryList()
+		: Owner(nullptr)
+	{}
+
+	/** Adds or updates an item, only marks it dirty if the data changed. Server only */
+	void SetItem(const FString& ItemKey, const FRPGItemData& ItemData);
+
+	/** Removes an item if present. Server only */
+	void RemoveItem(const FString& ItemKey);
+
+	/** Removes every item. Server only */
+	void Reset();
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FRPGInventoryEntry, FRPGInventoryList>(Items, DeltaParms, *this);
+	}
+
+	/** Controller that receives the client callbacks, set by the controller so it is never copied from an archetype */
+	ARPGPlayerControllerBase* Owner;
+
+private:
+	UPROPERTY()
+	TArray<FRPGInventoryEntry> Items;
+
+	/** Item key to index in Items, only maintained on the server */
+	TMap<FString, int32> ItemIndices;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRPGInventoryList> : public TStructOpsTypeTraitsBase2<FRPGInventoryList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/** The contents of one inventory slot as replicated to the owning client */
+USTRUCT()
+struct ACTIONRPG_API FRPGSlottedItemEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	FRPGSlottedItemEntry() {}
+
+	FRPGSlottedItemEntry(const FRPGItemSlot& InItemSlot, const FString& InItemKey)
+		: ItemSlot(InItemSlot)
+		, ItemKey(InItemKey)
+	{}
+
+	UPROPERTY()
+	FRPGItemSlot ItemSlot;
+
+	/** Key of the slotted item, empty if the slot is empty */
+	UPROPERTY()
+	FString ItemKey;
+
+	/** Client side callbacks, forward to the owning controller */
+	void PreReplicatedRemove(const struct FRPGSlottedItemList& InArraySerializer);
+	void PostReplicatedAdd(const struct FRPGSlottedItemList& InArraySerializer);
+	void PostReplicatedChange(const struct FRPGSlottedItemList& InArraySerializer);
+};
+
+/** Delta replicated list of slot contents, only slots marked dirty on the server are sent */
+USTRUCT()
+struct ACTIONRPG_API FRPGSlottedItemList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	FRPGSlottedItemList()
+		: Owner(nullptr)
+	{}
+
+	/** Sets the contents of a slot, only marks it dirty if it changed. Server only */
+	void SetSlot(const FRPGItemSlot& ItemSlot, const FString& ItemKey);
+
+	/** Removes every slot. Server only */
+	void Reset();
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FRPGSlottedItemEntry, FRPGSlottedItemList>(Slots, DeltaParms, *this);
+	}
+
+	/** Controller that receives the client callbacks, set by the controller so it is never copied from an archetype */
+	ARPGPlayerControllerBase* Owner;
+
+private:
+	UPROPERTY()
+	TArray<FRPGSlottedItemEntry> Slots;
+
+	/** Slot to index in Slots, only maintained on the server */
+	TMap<FRPGItemSlot, int32> SlotIndices;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRPGSlottedItemList> : public TStructOpsTypeTraitsBase2<FRPGSlottedItemList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
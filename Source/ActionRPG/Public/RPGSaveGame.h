@@ -0,0 +1,76 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "GameFramework/SaveGame.h"
+#include "RPGSaveGame.generated.h"
+
+/** List of versions, native code will handle fixups for any old versions */
+namespace ERPGSaveGameVersion
+{
+	enum type
+	{
+		// Initial version
+		Initial,
+		// Inventory stored as a binary blob of catalog ids
+		InventoryBlob,
+
+		// -----<new versions must be added before this line>-------------------------------------------------
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+}
+
+/**
+ * Plain copy of an inventory used for saving and loading, safe to encode and decode off the game thread
+ * Items are stored by catalog id. Their keys go into a table at the end that is only read when the catalog fingerprint no longer matches
+ */
+struct ACTIONRPG_API FRPGInventorySaveData
+{
+	/** Fingerprint of the catalog the ids came from */
+	uint32 CatalogFingerprint = 0;
+
+	/** Owned items, the arrays are parallel. ItemKeys is empty after a decode that could use the ids */
+	TArray<FString> ItemKeys;
+	TArray<FRPGItemId> ItemIds;
+	TArray<FRPGItemData> Items;
+
+	/** Contents of every slot by type then slot number, as an index into Items or INDEX_NONE if empty */
+	TArray<int32> SlotItems[(int32)ERPGItemType::Undefined];
+
+	/** Writes the compact binary form */
+	void Encode(TArray<uint8>& OutBytes) const;
+
+	/**
+	 * Reads the compact binary form, returns false if the data is corrupt or from an unknown version
+	 * The key table is skipped if the blob was written with CurrentCatalogFingerprint, the ids resolve to the same items then
+	 */
+	bool Decode(const TArray<uint8>& Bytes, uint32 CurrentCatalogFingerprint);
+
+	/** Returns true if Bytes decode back to exactly this data, for checking Encode in development builds */
+	bool RoundTrips(const TArray<uint8>& Bytes) const;
+};
+
+/** Object that is written to and read from the save game archive, with a data version */
+UCLASS(BlueprintType)
+class ACTIONRPG_API URPGSaveGame : public USaveGame
+{
+	GENERATED_BODY()
+
+public:
+	/** Constructor */
+	URPGSaveGame()
+	{
+		// Set to current version, this will get overwritten during serialization when loading
+		SavedDataVersion = ERPGSaveGameVersion::LatestVersion;
+	}
+
+	/** Encoded FRPGInventorySaveData */
+	UPROPERTY()
+	TArray<uint8> InventoryBlob;
+
+	/** What LatestVersion was when the archive was saved */
+	UPROPERTY()
+	int32 SavedDataVersion;
+};
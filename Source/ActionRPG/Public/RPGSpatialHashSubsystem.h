@@ -0,0 +1,86 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RPGSpatialHashSubsystem.generated.h"
+
+class ARPGCharacterBase;
+
+/**
+ * Grid of every live character in the world, for area targeting without physics traces
+ * Characters register themselves on BeginPlay. The grid is rebuilt at most once per frame, on the first query of that frame,
+ * so every ability targeting in the same frame shares one build. Characters are treated as upright cylinders of their capsule size
+ */
+UCLASS()
+class ACTIONRPG_API URPGSpatialHashSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	URPGSpatialHashSubsystem();
+
+	/** Adds a character to the grid, called by the character */
+	void RegisterCharacter(ARPGCharacterBase* Character);
+
+	/** Removes a character from the grid, called by the character */
+	void UnregisterCharacter(ARPGCharacterBase* Character);
+
+	/** Finds live characters overlapping a sphere */
+	UFUNCTION(BlueprintCallable, Category = Targeting)
+	void QuerySphere(const FVector& Center, float Radius, TArray<ARPGCharacterBase*>& OutCharacters);
+
+	/** Finds live characters inside a flat cone, HalfAngle is in degrees and Direction is flattened onto the ground */
+	UFUNCTION(BlueprintCallable, Category = Targeting)
+	void QueryCone(const FVector& Origin, const FVector& Direction, float Length, float HalfAngle, TArray<ARPGCharacterBase*>& OutCharacters);
+
+	/** Finds live characters overlapping a capsule from Start to End, same as a sphere sweep along that path */
+	UFUNCTION(BlueprintCallable, Category = Targeting)
+	void QueryCapsule(const FVector& Start, const FVector& End, float Radius, TArray<ARPGCharacterBase*>& OutCharacters);
+
+	/** Returns the subsystem for the world of an object */
+	static URPGSpatialHashSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Deinitialize() override;
+
+protected:
+	/** One character as of the last build */
+	struct FEntry
+	{
+		ARPGCharacterBase* Character;
+		FVector Location;
+		float Radius;
+		float HalfHeight;
+		uint64 CellKey;
+	};
+
+	/** Rebuilds the grid if it has not been built this frame */
+	void UpdateGrid();
+
+	/** Calls Visitor with every entry in cells touching the 2D box of Extent around Center */
+	template<typename VisitorType>
+	void ForEachCandidate(const FVector& Center, float Extent, VisitorType Visitor) const;
+
+	/** Returns the key of the cell containing a location */
+	uint64 GetCellKey(int32 CellX, int32 CellY) const;
+
+	/** Size of a grid cell in cm, about the radius of a typical area attack */
+	float CellSize;
+
+	/** Characters that are in play, a property so destroyed characters can't be left behind */
+	UPROPERTY(Transient)
+	TArray<ARPGCharacterBase*> RegisteredCharacters;
+
+	/** Entries sorted by cell, so each cell is one contiguous range */
+	TArray<FEntry> Entries;
+
+	/** Start and count of each occupied cell in Entries */
+	TMap<uint64, TPair<int32, int32>> Cells;
+
+	/** Largest character radius in the grid, queries grow by this so characters on cell borders are found */
+	float MaxEntryRadius;
+
+	/** Frame the grid was last built on */
+	uint64 BuiltFrame;
+};
@@ -74,6 +74,54 @@ struct ACTIONRPG_API FRPGItemSlot
 };
 
 
+/** Compact handle for an item in the game instance item catalog, resolved from the item key once at Init */
+USTRUCT(BlueprintType)
+struct ACTIONRPG_API FRPGItemId
+{
+	GENERATED_BODY()
+
+	/** Constructor, -1 means an invalid id */
+	FRPGItemId()
+		: ItemType(ERPGItemType::Undefined)
+		, Index(INDEX_NONE)
+	{}
+
+	FRPGItemId(ERPGItemType InItemType, int32 InIndex)
+		: ItemType(InItemType)
+		, Index(InIndex)
+	{}
+
+	/** The type of the item, selects which catalog array Index points into */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Item)
+	ERPGItemType ItemType;
+
+	/** Dense index into the per-type catalog array. Only stable until the catalog is rebuilt */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Item)
+	int32 Index;
+
+	/** Equality operators */
+	bool operator==(const FRPGItemId& Other) const
+	{
+		return ItemType == Other.ItemType && Index == Other.Index;
+	}
+	bool operator!=(const FRPGItemId& Other) const
+	{
+		return !(*this == Other);
+	}
+
+	/** Implemented so it can be used in Maps/Sets */
+	friend inline uint32 GetTypeHash(const FRPGItemId& Key)
+	{
+		return HashCombine(GetTypeHash(Key.ItemType), (uint32)Key.Index);
+	}
+
+	/** Returns true if this points at a catalog entry */
+	bool IsValid() const
+	{
+		return ItemType != ERPGItemType::Undefined && Index >= 0;
+	}
+};
+
 /** Extra information about a URPGItem that is in a player's inventory */
 USTRUCT(BlueprintType)
 struct ACTIONRPG_API FRPGItemData
@@ -140,6 +188,121 @@ struct ACTIONRPG_API FRPGItemData
 	}
 };
 
+/** A single coalesced inventory item change, part of FRPGInventoryChangeSet */
+USTRUCT(BlueprintType)
+struct ACTIONRPG_API FRPGInventoryItemChange
+{
+	GENERATED_BODY()
+
+	FRPGInventoryItemChange()
+		: bAdded(false)
+		, ItemType(ERPGItemType::Undefined)
+	{}
+
+	FRPGInventoryItemChange(bool bInAdded, const FString& InItemKey, ERPGItemType InItemType)
+		: bAdded(bInAdded)
+		, ItemKey(InItemKey)
+		, ItemType(InItemType)
+	{}
+
+	/** True if the item was added or updated, false if it was removed or its count went down */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Item)
+	bool bAdded;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Item)
+	FString ItemKey;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Item)
+	ERPGItemType ItemType;
+};
+
+/** A single coalesced slot change, part of FRPGInventoryChangeSet */
+USTRUCT(BlueprintType)
+struct ACTIONRPG_API FRPGSlottedItemChange
+{
+	GENERATED_BODY()
+
+	FRPGSlottedItemChange()
+		: ItemType(ERPGItemType::Undefined)
+	{}
+
+	FRPGSlottedItemChange(const FRPGItemSlot& InItemSlot, const FString& InItemKey, ERPGItemType InItemType)
+		: ItemSlot(InItemSlot)
+		, ItemKey(InItemKey)
+		, ItemType(InItemType)
+	{}
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Item)
+	FRPGItemSlot ItemSlot;
+
+	/** Key of the item now in the slot, empty if the slot was cleared */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Item)
+	FString ItemKey;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Item)
+	ERPGItemType ItemType;
+};
+
+/** Every inventory and slot change made during an inventory transaction, with at most one entry per item and per slot */
+USTRUCT(BlueprintType)
+struct ACTIONRPG_API FRPGInventoryChangeSet
+{
+	GENERATED_BODY()
+
+	/** Changed items, in the order they were first changed */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Item)
+	TArray<FRPGInventoryItemChange> ItemChanges;
+
+	/** Changed slots, in the order they were first changed */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Item)
+	TArray<FRPGSlottedItemChange> SlotChanges;
+
+	/** Returns true if nothing changed */
+	bool IsEmpty() const
+	{
+		return ItemChanges.Num() == 0 && SlotChanges.Num() == 0;
+	}
+
+	/** Records an item change, replacing any earlier change to the same item */
+	void AddItemChange(bool bAdded, const FString& ItemKey, ERPGItemType ItemType)
+	{
+		if (const int32* ExistingIndex = ItemChangeIndices.Find(ItemKey))
+		{
+			ItemChanges[*ExistingIndex] = FRPGInventoryItemChange(bAdded, ItemKey, ItemType);
+		}
+		else
+		{
+			ItemChangeIndices.Add(ItemKey, ItemChanges.Emplace(bAdded, ItemKey, ItemType));
+		}
+	}
+
+	/** Records a slot change, replacing any earlier change to the same slot */
+	void AddSlotChange(const FRPGItemSlot& ItemSlot, const FString& ItemKey, ERPGItemType ItemType)
+	{
+		if (const int32* ExistingIndex = SlotChangeIndices.Find(ItemSlot))
+		{
+			SlotChanges[*ExistingIndex] = FRPGSlottedItemChange(ItemSlot, ItemKey, ItemType);
+		}
+		else
+		{
+			SlotChangeIndices.Add(ItemSlot, SlotChanges.Emplace(ItemSlot, ItemKey, ItemType));
+		}
+	}
+
+	void Reset()
+	{
+		ItemChanges.Reset();
+		SlotChanges.Reset();
+		ItemChangeIndices.Reset();
+		SlotChangeIndices.Reset();
+	}
+
+private:
+	/** Indices into the arrays above, used to coalesce repeated changes */
+	TMap<FString, int32> ItemChangeIndices;
+	TMap<FRPGItemSlot, int32> SlotChangeIndices;
+};
+
 /** Delegate called when an inventory item changes */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnInventoryItemChanged, bool, bAdded, FString, ItemKey, ERPGItemType, ItemType);
 DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnInventoryItemChangedNative, bool, FString, ERPGItemType);
@@ -148,6 +311,13 @@ DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnInventoryItemChangedNative, bool, FStr
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnSlottedItemChanged, FRPGItemSlot, ItemSlot, FString, ItemKey, ERPGItemType, ItemType);
 DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnSlottedItemChangedNative, FRPGItemSlot, FString, ERPGItemType);
 
+/** Delegate called when an inventory transaction is committed, with every change made during it */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInventoryChangeSet, const FRPGInventoryChangeSet&, ChangeSet);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnInventoryChangeSetNative, const FRPGInventoryChangeSet&);
+
 /** Delegate called when the entire inventory has been loaded, all items may have been replaced */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnInventoryLoaded);
-DECLARE_MULTICAST_DELEGATE(FOnInventoryLoadedNative);
\ No newline at end of file
+DECLARE_MULTICAST_DELEGATE(FOnInventoryLoadedNative);
+/** Delegate called when the soft referenced assets of a set of items have been loaded, Undefined if the items were of several types */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnItemAssetsLoaded, ERPGItemType, ItemType);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnItemAssetsLoadedNative, ERPGItemType);
@@ -0,0 +1,52 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "ActionRPG.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RPGPoolableInterface.h"
+#include "RPGWeaponPoolSubsystem.generated.h"
+
+/**
+ * Recycles weapon actors instead of spawning one on every equip and destroying it on every unequip or death
+ * Released weapons are detached, hidden and have collision and tick disabled until they are acquired again
+ * Actors implementing RPGPoolableInterface are told when they enter and leave the pool
+ */
+UCLASS()
+class ACTIONRPG_API URPGWeaponPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Returns a weapon of the class at the transform, taken from the pool or spawned if the pool is empty */
+	UFUNCTION(BlueprintCallable, Category = Weapon)
+	AActor* AcquireWeapon(TSubclassOf<AActor> WeaponClass, const FTransform& SpawnTransform, AActor* WeaponOwner);
+
+	/** Puts a weapon back into the pool, use instead of destroying it */
+	UFUNCTION(BlueprintCallable, Category = Weapon)
+	void ReleaseWeapon(AActor* Weapon);
+
+	/** Spawns weapons into the pool until it has at least Count free actors of the class */
+	UFUNCTION(BlueprintCallable, Category = Weapon)
+	void PrewarmWeapon(TSubclassOf<AActor> WeaponClass, int32 Count);
+
+	/** Prewarms every weapon in the item catalog by its PoolPrewarmCount, streaming in weapon classes that are not loaded yet */
+	UFUNCTION(BlueprintCallable, Category = Weapon)
+	void PrewarmFromCatalog();
+
+	/** Returns the subsystem for the world of an object */
+	static URPGWeaponPoolSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Deinitialize() override;
+
+protected:
+	/** Prewarms catalog weapons whose class is loaded */
+	void PrewarmLoadedCatalogWeapons();
+
+	/** Spawns a weapon that is not in the pool */
+	AActor* SpawnWeapon(UClass* WeaponClass, const FTransform& SpawnTransform, AActor* WeaponOwner);
+
+	/** Free weapons by class */
+	UPROPERTY(Transient)
+	TMap<UClass*, FRPGPooledActorList> FreeWeapons;
+};